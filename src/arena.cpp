@@ -0,0 +1,192 @@
+#include <cstdlib>
+#include <mutex>
+#include "utility.hpp"
+#include "arena.hpp"
+
+#pragma comment(lib, "Advapi32.lib")
+
+/**
+ * Enables the privilege to lock pages in memory, which large pages need. The
+ * account must hold it; enabling is done once per process.
+ * @return true if it is enabled; otherwise, false.
+ */
+static bool EnableLockMemory(void)
+{
+    static std::once_flag once;
+    static bool enabled = false;
+
+    std::call_once(once, []()
+    {
+        TOKEN_PRIVILEGES privileges;
+        HANDLE token;
+
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+        {
+            return;
+        }
+
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+        // Adjusting succeeds for privileges not held, hence the last error.
+        if (LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+            AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr))
+        {
+            enabled = (GetLastError() == ERROR_SUCCESS);
+        }
+
+        CloseHandle(token);
+    });
+
+    return enabled;
+}
+
+Arena::Arena(void)
+{
+    data = nullptr;
+    size = 0;
+    reserved = 0;
+    committed = 0;
+    flags = ARENA_DEFAULT;
+}
+
+Arena::~Arena(void)
+{
+    Release();
+}
+
+/**
+ * Creates the arena, an arena can only be created once.
+ * @param size The number of bytes.
+ * @param flags The ARENA_* flags to use.
+ */
+void Arena::Create(size_t size, int flags)
+{
+    ASSERT(data == nullptr, "Arena already created.");
+
+    this->size = size;
+    this->flags = flags;
+
+    // An empty fast file still has an arena.
+    if (size == 0)
+    {
+        size = 1;
+    }
+
+    if (flags & ARENA_CALLOC)
+    {
+        data = (char*)calloc(size, 1);
+        if (data == nullptr)
+        {
+            throw Exception("Out of memory (data_s)");
+        }
+
+        reserved = size;
+        committed = size;
+        return;
+    }
+
+    // Fall back to pages of the normal size.
+    if ((flags & ARENA_LARGE_PAGES) && CreateLarge(size))
+    {
+        return;
+    }
+    this->flags &= ~ARENA_LARGE_PAGES;
+
+    data = (char*)VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+    if (data == nullptr)
+    {
+        throw Exception("Could not reserve the address space (data_s)");
+    }
+
+    reserved = size;
+    committed = 0;
+}
+
+/**
+ * Allocates the arena in large pages. These can not be committed in parts,
+ * the whole arena is committed and locked at once.
+ */
+bool Arena::CreateLarge(size_t size)
+{
+    size_t minimum;
+
+    minimum = GetLargePageMinimum();
+    if (minimum == 0 || !EnableLockMemory())
+    {
+        return false;
+    }
+
+    size = ALIGN(size, minimum);
+    data = (char*)VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    reserved = size;
+    committed = size;
+    return true;
+}
+
+void Arena::Release(void) noexcept
+{
+    if (data != nullptr)
+    {
+        if (flags & ARENA_CALLOC)
+        {
+            free(data);
+        }
+        else
+        {
+            VirtualFree(data, 0, MEM_RELEASE);
+        }
+        data = nullptr;
+    }
+
+    size = 0;
+    reserved = 0;
+    committed = 0;
+}
+
+char* Arena::GetData(void)
+{
+    return data;
+}
+
+size_t Arena::GetSize(void)
+{
+    return size;
+}
+
+bool Arena::IsLarge(void)
+{
+    return ((flags & ARENA_LARGE_PAGES) != 0);
+}
+
+/**
+ * Commits whole chunks up to and including the given end.
+ * @param end The number of bytes, counted from the start.
+ */
+void Arena::CommitChunks(size_t end)
+{
+    size_t target;
+
+    if (end > reserved)
+    {
+        throw Exception("Tried to commit %zu bytes beyond the arena.", end - reserved);
+    }
+
+    target = ALIGN(end, (size_t)ARENA_CHUNK);
+    if (target > reserved)
+    {
+        target = reserved;
+    }
+
+    if (VirtualAlloc(data + committed, target - committed, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+    {
+        throw Exception("Out of memory (data_s)");
+    }
+
+    committed = target;
+}
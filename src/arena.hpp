@@ -0,0 +1,62 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include "utility.hpp"
+
+#define ARENA_DEFAULT       0x00
+#define ARENA_CALLOC        0x01        /* Allocate and zero it all up front, for comparison. */
+#define ARENA_LARGE_PAGES   0x02        /* Large pages when the privilege is held, all committed. */
+
+#define ARENA_CHUNK         0x100000    /* Committed at once as the arena fills. */
+
+/**
+ * The memory of a fast file. The address range is reserved as a whole and
+ * committed in chunks as it is filled, so nothing is zeroed or charged before
+ * it is needed. Committed pages are zero, just like calloc.
+ */
+class Arena
+{
+public:
+    Arena(void);
+    ~Arena(void);
+
+    void Create(size_t size, int flags = ARENA_DEFAULT);
+    void Release(void) noexcept;
+
+    char* GetData(void);
+    size_t GetSize(void);
+    bool IsLarge(void);
+
+    /**
+     * Ensures the first bytes of the arena are committed.
+     * @param end The number of bytes, counted from the start.
+     */
+    void Commit(size_t end)
+    {
+        if (end > committed)
+        {
+            CommitChunks(end);
+        }
+    }
+
+    /**
+     * Gets the number of committed bytes past an offset.
+     */
+    size_t GetCommitted(size_t offset)
+    {
+        return (offset < committed) ? (committed - offset) : 0;
+    }
+
+private:
+    void CommitChunks(size_t end);
+    bool CreateLarge(size_t size);
+
+private:
+    char *data;
+    size_t size;
+    size_t reserved;
+    size_t committed;
+    int flags;
+};
+
+#endif /* ARENA_HPP */
@@ -15,7 +15,26 @@ void Asset::Release(void) noexcept
     // By default the asset has nothing to release.
 }
 
-const char *lpAssetType[0x21] = {
+const char* Asset::GetName(void)
+{
+    // By default the asset has no name.
+    return nullptr;
+}
+
+void Asset::Dump(class FastFile *ff)
+{
+    // By default the asset has nothing to print.
+    UNREFERENCED_PARAMETER(ff);
+}
+
+void Asset::Export(class FastFile *ff, class Exporter *exporter)
+{
+    // By default the asset has nothing to export.
+    UNREFERENCED_PARAMETER(ff);
+    UNREFERENCED_PARAMETER(exporter);
+}
+
+const char *lpAssetType[ASSET_TYPE_COUNT] = {
     "xmodelpieces",
     "physpreset",
     "xanim",
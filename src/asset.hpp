@@ -14,7 +14,7 @@
 #define ASSET_TYPE_IMAGE                6
 #define ASSET_TYPE_SOUND                7
 #define ASSET_TYPE_SNDCURVE             8
-#define ASSET_TYPE_LOADED_SOUND         9           /* NONE */
+#define ASSET_TYPE_LOADED_SOUND         9
 #define ASSET_TYPE_COL_MAP_SP           0x0A
 #define ASSET_TYPE_COL_MAP_MP           0x0B
 #define ASSET_TYPE_COM_MAP              0x0C        /* SP & MP */
@@ -38,20 +38,25 @@
 #define ASSET_TYPE_XMODELALIAS          0x1E        /* NONE */
 #define ASSET_TYPE_RAWFILE              0x1F
 #define ASSET_TYPE_STRINGTABLE          0x20
+#define ASSET_TYPE_COUNT                0x21
+
+#define DUMP_OFFSET                     32          /* Column of the values in dumps. */
 
 class Asset 
 {
 public:
     Asset(void);
-    ~Asset(void);
+    virtual ~Asset(void);
     virtual void Release(void) noexcept;
+    virtual const char* GetName(void);
 
     virtual void Load(class FastFile *ff, address_t *handle) = 0;
     virtual void Store(class FastFile *ff, address_t *handle) = 0;
-    //virtual void Export(Buffer_t *buffer) = 0;
+    virtual void Dump(class FastFile *ff);
+    virtual void Export(class FastFile *ff, class Exporter *exporter);
 };
 
 /** Allows looking up the names of asset types. */
-extern const char *lpAssetType[0x21];
+extern const char *lpAssetType[ASSET_TYPE_COUNT];
 
 #endif /* ASSET_HPP */
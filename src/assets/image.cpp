@@ -18,11 +18,19 @@ void Image::Release(void) noexcept
     name = nullptr;
 }
 
+const char* Image::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
 void Image::Load(class FastFile *ff, address_t *handle)
 {
-    address_t handler[9];
+    const address_t *handler;
+    const uint32_t *buffer;
+    address_t name_p;
 
-    ASSERT(
+    CHECK(Policy,
         *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
         "Internal error (0x%08X)",
             *handle
@@ -32,8 +40,8 @@ void Image::Load(class FastFile *ff, address_t *handle)
     if (*handle == ADDRESS_FOLLOWING)
     {
         // Read the image values.
-        ff->ReadMemory(handler, 9*4);
-        ASSERT(
+        handler = (const address_t*)ff->BorrowMemory(9*4);
+        CHECK(Policy,
             handler[8] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X)",
                 handler[8]
@@ -47,20 +55,19 @@ void Image::Load(class FastFile *ff, address_t *handle)
         #endif
 
         // Read the image name.
-        if (handler[8] != ADDRESS_FOLLOWING)
+        name_p = handler[8];
+        if (name_p != ADDRESS_FOLLOWING)
         {
-            name = ff->GetPointer(handler[8]);
+            name = ff->GetPointer<Policy>(name_p);
         }
         else
         {
             // Read the name of the image.
-            name = ff->ReadSharedString(64);
-            handler[8] = ff->GetAddress(4, name);
+            name = ff->ReadSharedString();
         }
 
         // Read the referenced image data.
-        uint32_t buffer[3];
-        ff->ReadMemory(buffer, 3*4);
+        buffer = (const uint32_t*)ff->BorrowMemory(3*4);
 
         metadata.type = static_cast<uint8_t>((buffer[0] >> 0x00) & 0xFF);
         metadata.type = static_cast<uint8_t>((buffer[0] >> 0x08) & 0xFF);
@@ -75,14 +82,24 @@ void Image::Load(class FastFile *ff, address_t *handle)
         //   Usage unknown; but a pointer to the image data is most likely.
         uint32_t *ref = (uint32_t*)ff->ReadSharedMemory(4, 4);
 
-        ASSERT(
+        CHECK(Policy,
             *ref == 0u,
             "Corrupted data. (0x%08X)",
                 *ref
         );
     }
+}
 
-    Store(ff, handle);
+void Image::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
 }
 
 void Image::Store(class FastFile *ff, address_t *handle)
@@ -91,6 +108,37 @@ void Image::Store(class FastFile *ff, address_t *handle)
     UNREFERENCED_PARAMETER(handle);
 }
 
+/**
+ * Prints the name and the metadata of the image.
+ */
+void Image::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    VERBOSE("\nIMAGE\n\t%-*s%s\n", DUMP_OFFSET, "image->name", name);
+
+    VERBOSE("\t%-*s%hhu\n", DUMP_OFFSET, "image->metadata.type", metadata.type);
+    VERBOSE("\t%-*s%hhu\n", DUMP_OFFSET, "image->metadata.usage", metadata.usage);
+
+    VERBOSE("\t%-*s%hu\n", DUMP_OFFSET, "image->metadata.width", metadata.width);
+    VERBOSE("\t%-*s%hu\n", DUMP_OFFSET, "image->metadata.height", metadata.height);
+    VERBOSE("\t%-*s%hu\n", DUMP_OFFSET, "image->metadata.flags", metadata.flags);
+
+    uint32_t format = metadata.format;
+
+    if (format == 0x31545844 ||
+        format == 0x33545844 ||
+        format == 0x35545844)
+    {
+        VERBOSE("\t%-*s%.4s\n", DUMP_OFFSET, "image->metadata.format",
+            (char*)(&(metadata.format)));
+    }
+    else
+    {
+        VERBOSE("\t%-*s%i\n", DUMP_OFFSET, "image->metadata.format", metadata.format);
+    }
+}
+
 /**
  * FORMAT DOCUMENTATION
  * [00] int32       .                   | 3 = 2D / 5 = Skybox
@@ -12,9 +12,15 @@ public:
     Image(void);
     ~Image(void);
     void Release(void) noexcept;
+    const char* GetName(void);
 
     void Load(class FastFile *ff, address_t *handle);
     void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
+
+private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
 
 ASSET_PROPERTIES:
     char *name;
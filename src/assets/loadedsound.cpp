@@ -0,0 +1,258 @@
+#include <cstring>
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "../writer.hpp"
+#include "../exporter.hpp"
+#include "loadedsound.hpp"
+
+LoadedSound::LoadedSound(void)
+{
+    header = nullptr;
+    name = nullptr;
+    data = { nullptr, 0 };
+}
+
+LoadedSound::~LoadedSound(void)
+{
+    Release();
+}
+
+void LoadedSound::Release(void) noexcept
+{
+    header = nullptr;
+    name = nullptr;
+    data = { nullptr, 0 };
+}
+
+const char* LoadedSound::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
+void LoadedSound::Load(class FastFile *ff, address_t *handle)
+{
+    struct LoadedSoundHeader *handler;
+
+    CHECK(Policy,
+        *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
+        "Internal error (0x%08X)",
+            *handle
+    );
+
+    // Only load when the data is there.
+    if (*handle == ADDRESS_FOLLOWING)
+    {
+        // Read the sound values.
+        handler = (struct LoadedSoundHeader*)ff->ReadSharedMemory(sizeof(struct LoadedSoundHeader), 4);
+        *handle = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, handler);
+
+        CHECK(Policy,
+            handler->name != ADDRESS_MISSING,
+            "Corrupted data. (0x%08X)",
+                handler->name
+        );
+        CHECK(Policy,
+            handler->info.data_len <= 0x7FFFFFFF,
+            "Corrupted data. (%u bytes)",
+                handler->info.data_len
+        );
+
+        // Read the name of the sound.
+        if (handler->name == ADDRESS_FOLLOWING)
+        {
+            name = ff->ReadSharedString();
+            handler->name = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, name);
+        }
+        else
+        {
+            name = ff->GetPointer<Policy>(handler->name);
+        }
+        VERBOSE("loaded_sound->name = '%s'\n", name);
+
+        // Read the samples, they are exported from where they are.
+        ff->ReadArray<Policy>(&handler->data, (int)handler->info.data_len, -1);
+    }
+}
+
+void LoadedSound::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
+}
+
+/**
+ * Stores the sound by pointing into the memory of the fast file. It may be
+ * within a sound alias, hence the handle need not be of an asset.
+ * @param handle The handle to the sound in memory.
+ */
+template <class Policy>
+void LoadedSound::Store(class FastFile *ff, address_t *handle)
+{
+    CHECK(Policy,
+        *handle != ADDRESS_FOLLOWING,
+        "Corrupted data. (0x%08X)",
+            *handle
+    );
+
+    // Only load the data if there is data.
+    if (*handle != ADDRESS_MISSING)
+    {
+        header = (const struct LoadedSoundHeader*)ff->GetPointer<Policy>(*handle);
+        name = ff->GetPointer<Policy>(header->name);
+        ff->GetSpan<Policy>(header->data, (int)header->info.data_len, &data);
+    }
+}
+
+void LoadedSound::Store(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Store<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Store<Checked>(ff, handle);
+    }
+}
+
+void LoadedSound::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    VERBOSE("\nLOADED_SOUND\n\t%-*s%s\n\t%-*s0x%04X\n\t%-*s%u Hz, %i bits, %i channels\n\t%-*s%u (%u bytes)\n",
+        DUMP_OFFSET, "name", name,
+        DUMP_OFFSET, "format", header->info.format,
+        DUMP_OFFSET, "rate", header->info.rate, header->info.bits, header->info.channels,
+        DUMP_OFFSET, "samples", header->info.samples, header->info.data_len
+    );
+}
+
+const struct LoadedSoundHeader* LoadedSound::GetHeader(void)
+{
+    return header;
+}
+
+/**
+ * Gets the number of bytes of the samples, none when they were not loaded.
+ */
+int LoadedSound::GetSize(void)
+{
+    return data.count;
+}
+
+/**
+ * Puts a little endian value of a number of bytes into a header.
+ */
+static int PutValue(unsigned char *dest, unsigned int value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        dest[i] = (unsigned char)(value >> (i * 8));
+    }
+
+    return bytes;
+}
+
+/**
+ * Writes the samples as a WAV file. Only the header is made up, the samples
+ * are written straight from the memory of the fast file.
+ * @param writer The writer, with the file open.
+ */
+void LoadedSound::ExportWav(class Writer *writer)
+{
+    const struct MssSoundInfo *info;
+    unsigned char wav[LOADED_SOUND_WAV_SIZE];
+    unsigned int blockAlign, samplesPerBlock;
+    int size = 0;
+
+    ASSERT(header != nullptr && data.count > 0, "Sound has no samples. (%s)", name);
+
+    info = &header->info;
+    ASSERT(info->format == LOADED_SOUND_PCM || info->format == LOADED_SOUND_ADPCM,
+        "Unsupported sound format. (%s, 0x%04X)", name, info->format);
+    ASSERT(info->channels > 0 && info->bits > 0, "Corrupted sound. (%s)", name);
+
+    // IMA ADPCM packs a sample of each channel into the header of a block,
+    // then eight samples into each four bytes per channel.
+    if (info->format == LOADED_SOUND_ADPCM)
+    {
+        ASSERT(info->block_size > (unsigned int)(4 * info->channels), "Corrupted sound. (%s)", name);
+        blockAlign = info->block_size;
+        samplesPerBlock = ((((blockAlign - (4 * info->channels)) * 8) / (4 * info->channels)) + 1);
+    }
+    else
+    {
+        blockAlign = (unsigned int)((info->channels * info->bits) / 8);
+        samplesPerBlock = 1;
+    }
+
+    size += PutValue(&wav[size], 0x46464952, 4);                            // RIFF
+    size += 4;                                                              // The size, once known
+    size += PutValue(&wav[size], 0x45564157, 4);                            // WAVE
+    size += PutValue(&wav[size], 0x20746D66, 4);                            // fmt
+    size += PutValue(&wav[size], (info->format == LOADED_SOUND_ADPCM) ? 20 : 16, 4);
+    size += PutValue(&wav[size], (unsigned int)info->format, 2);
+    size += PutValue(&wav[size], (unsigned int)info->channels, 2);
+    size += PutValue(&wav[size], info->rate, 4);
+    size += PutValue(&wav[size], (unsigned int)(((unsigned long long)info->rate * blockAlign) / samplesPerBlock), 4);
+    size += PutValue(&wav[size], blockAlign, 2);
+    size += PutValue(&wav[size], (unsigned int)info->bits, 2);
+
+    if (info->format == LOADED_SOUND_ADPCM)
+    {
+        size += PutValue(&wav[size], 2, 2);
+        size += PutValue(&wav[size], samplesPerBlock, 2);
+        size += PutValue(&wav[size], 0x74636166, 4);                        // fact
+        size += PutValue(&wav[size], 4, 4);
+        size += PutValue(&wav[size], info->samples, 4);
+    }
+
+    size += PutValue(&wav[size], 0x61746164, 4);                            // data
+    size += PutValue(&wav[size], (unsigned int)data.count, 4);
+
+    // A chunk of an odd size is followed by a pad byte, which the RIFF counts
+    // but the data chunk does not.
+    PutValue(&wav[4], (unsigned int)(size - 8 + data.count + (data.count & 1)), 4);
+
+    writer->Write((const char*)wav, (size_t)size);
+    writer->WriteThrough(data.data, (size_t)data.count);
+    if (data.count & 1)
+    {
+        writer->WriteChar(0);
+    }
+}
+
+/**
+ * Exports the samples to a WAV file named after the sound. A sound used by
+ * several aliases is written once.
+ */
+void LoadedSound::Export(class FastFile *ff, class Exporter *exporter)
+{
+    size_t length;
+
+    UNREFERENCED_PARAMETER(ff);
+
+    if (data.count == 0 || !exporter->Claim(header))
+    {
+        return;
+    }
+
+    length = strlen(name);
+    ExportWav(exporter->OpenFile(name,
+        (length >= 4 && _stricmp(&name[length - 4], ".wav") == 0) ? L"" : L".wav"));
+    exporter->CloseFile();
+}
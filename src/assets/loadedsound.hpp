@@ -0,0 +1,74 @@
+#ifndef LOADEDSOUND_HPP
+#define LOADEDSOUND_HPP
+
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "../writer.hpp"
+#include "../exporter.hpp"
+
+#define LOADED_SOUND_PCM        0x0001  /* WAVE_FORMAT_PCM */
+#define LOADED_SOUND_ADPCM      0x0011  /* WAVE_FORMAT_IMA_ADPCM */
+#define LOADED_SOUND_WAV_SIZE   60      /* The largest WAV header, that of IMA ADPCM. */
+
+/*
+ * The structures as they are within the fast file, see FORMAT DOCUMENTATION.
+ * Pointers are addresses, which Store translates.
+ */
+
+/** The _AILSOUNDINFO of the Miles Sound System. */
+struct MssSoundInfo
+{
+    int format;                         // LOADED_SOUND_*
+    address_t data_ptr;                 // Set at runtime
+    unsigned int data_len;
+    unsigned int rate;
+    int bits;
+    int channels;
+    unsigned int samples;
+    unsigned int block_size;
+    address_t initial_ptr;              // Set at runtime
+};
+
+struct LoadedSoundHeader
+{
+    address_t name;
+    struct MssSoundInfo info;
+    address_t data;                     // Of info.data_len bytes, without a WAV header
+};
+
+static_assert(sizeof(struct LoadedSoundHeader) == 0x2C, "LoadedSound is 44 bytes.");
+
+class LoadedSound : public Asset
+{
+public:
+    LoadedSound(void);
+    ~LoadedSound(void);
+    void Release(void) noexcept;
+    const char* GetName(void);
+
+    void Load(class FastFile *ff, address_t *handle);
+    void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
+    void Export(class FastFile *ff, class Exporter *exporter);
+
+    const struct LoadedSoundHeader* GetHeader(void);
+    int GetSize(void);
+
+    // Writes the samples as a WAV file
+    void ExportWav(class Writer *writer);
+
+private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
+    template <class Policy>
+    void Store(class FastFile *ff, address_t *handle);
+
+ASSET_PROPERTIES:
+    const struct LoadedSoundHeader *header;
+    char *name;
+    struct Span<char> data;
+};
+
+#endif /* LOADEDSOUND_HPP */
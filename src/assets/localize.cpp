@@ -20,11 +20,18 @@ void Localize::Release(void) noexcept
     value = nullptr;
 }
 
+const char* Localize::GetName(void)
+{
+    return key;
+}
+
+template <class Policy>
 void Localize::Load(class FastFile *ff, address_t *handle)
 {
-    address_t handler[2];
+    const address_t *handler;
+    address_t value_p, key_p;
 
-    ASSERT(
+    CHECK(Policy,
         *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
         "Internal error (0x%08X)",
             *handle
@@ -34,37 +41,51 @@ void Localize::Load(class FastFile *ff, address_t *handle)
     if (*handle == ADDRESS_FOLLOWING)
     {
         // Read the localize values.
-        ff->ReadMemory(handler, 8);
-        ASSERT(
+        handler = (const address_t*)ff->BorrowMemory(8);
+        CHECK(Policy,
             handler[0] != ADDRESS_MISSING && handler[1] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X, 0x%08X)",
                 handler[0], handler[1]
         );
 
+        // The values are gone with the next read.
+        value_p = handler[0];
+        key_p = handler[1];
+
         // Value
-        if (handler[0] != ADDRESS_FOLLOWING)
+        if (value_p != ADDRESS_FOLLOWING)
         {
-            value = ff->GetPointer(handler[0]);
+            value = ff->GetPointer<Policy>(value_p);
         }
         else
         {
             // Read the value of the localize
-            value = ff->ReadSharedString(64);
+            value = ff->ReadSharedString();
         }
 
         // Key
-        if (handler[1] != ADDRESS_FOLLOWING)
+        if (key_p != ADDRESS_FOLLOWING)
         {
-            key = ff->GetPointer(handler[1]);
+            key = ff->GetPointer<Policy>(key_p);
         }
         else
         {
             // Read the key of the localize
-            key = ff->ReadSharedString(64);
+            key = ff->ReadSharedString();
         }
     }
+}
 
-    Store(ff, handle);
+void Localize::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
 }
 
 void Localize::Store(class FastFile *ff, address_t *handle)
@@ -73,6 +94,17 @@ void Localize::Store(class FastFile *ff, address_t *handle)
     UNREFERENCED_PARAMETER(handle);
 }
 
+/**
+ * Prints the key and the value of the localize.
+ */
+void Localize::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    VERBOSE("\nLOCALIZE\n\t%s\n\t%s\n",
+        key, value);
+}
+
 
 /**
  * FORMAT DOCUMENTATION
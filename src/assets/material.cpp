@@ -18,46 +18,59 @@ void Material::Release(void) noexcept
     name = nullptr;
 }
 
+const char* Material::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
 void Material::Load(class FastFile *ff, address_t *handle)
 {
-    union
-    {
-        address_t handler[20];
-        int values[20];
-    };
+    const address_t *handler;
+    address_t name_p;
 
     // Only load when the data is there.
     if (*handle == ADDRESS_FOLLOWING)
     {
         // Read the material values.
-        ff->ReadMemory(handler, 20*4);
-        ASSERT(
+        handler = (const address_t*)ff->BorrowMemory(20*4);
+        CHECK(Policy,
             handler[0] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X)",
                 handler[0]
         );
 
         // Read the material name.
-        if (handler[0] != ADDRESS_FOLLOWING)
+        name_p = handler[0];
+        if (name_p != ADDRESS_FOLLOWING)
         {
-            name = ff->GetPointer(handler[0]);
+            name = ff->GetPointer<Policy>(name_p);
         }
         else
         {
             // Read the name of the material.
-            name = ff->ReadSharedString(64);
-            handler[0] = ff->GetAddress(4, name);
+            name = ff->ReadSharedString();
         }
         VERBOSE("material->name = '%s'\n", name);
 
         // NOTE: clusters of 3-bytes
-        address_t buffer[3];
-        ff->ReadMemory(buffer, 3*4);
+        ff->BorrowMemory(3*4);
 
     }
 
     ASSERT(FALSE, "Not yet implemented.\n");
-    Store(ff, handle);
+}
+
+void Material::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
 }
 
 // 0: 256
@@ -76,6 +89,17 @@ void Material::Store(class FastFile *ff, address_t *handle)
     UNREFERENCED_PARAMETER(handle);
 }
 
+/**
+ * Prints the name of the material.
+ */
+void Material::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    VERBOSE("\nMATERIAL\n\t%-*s%s\n", DUMP_OFFSET,
+        "material->name", name);
+}
+
 /**
  * FORMAT DOCUMENTATION
  * [00] int32       name_p
@@ -39,16 +39,20 @@ void Physpreset::Release(void) noexcept
     tempDefaultToCylinder = false;
 }
 
+const char* Physpreset::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
 void Physpreset::Load(class FastFile *ff, address_t *handle)
 {
-    union
-    {
-        address_t handler[11];
-        int properties_i[11];
-        float properties_f[11];
-    };
+    const address_t *handler;
+    const int *properties_i;
+    const float *properties_f;
+    address_t name_p, sndAliasPrefix_p;
 
-    ASSERT(
+    CHECK(Policy,
         *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
         "Internal error (0x%08X)",
             *handle
@@ -58,8 +62,10 @@ void Physpreset::Load(class FastFile *ff, address_t *handle)
     if (*handle == ADDRESS_FOLLOWING)
     {
         // Read the physpreset values.
-        ff->ReadMemory(handler, 44);
-        ASSERT(
+        handler = (const address_t*)ff->BorrowMemory(44);
+        properties_i = (const int*)handler;
+        properties_f = (const float*)handler;
+        CHECK(Policy,
             handler[0] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X)",
                 handler[0]
@@ -76,28 +82,32 @@ void Physpreset::Load(class FastFile *ff, address_t *handle)
         piecesUpwardVelocity    = (properties_f[9]);
         tempDefaultToCylinder   = (properties_i[10] != 0) ? true : false;
 
+        // The values are gone with the next read.
+        name_p = handler[0];
+        sndAliasPrefix_p = handler[7];
+
         // Load the name.
-        if (handler[0] != ADDRESS_FOLLOWING)
+        if (name_p != ADDRESS_FOLLOWING)
         {
-            name = ff->GetPointer(handler[0]);
+            name = ff->GetPointer<Policy>(name_p);
         }
         else
         {
             // Read the name of the physicspreset.
-            name = ff->ReadSharedString(64);
+            name = ff->ReadSharedString();
         }
 
         // Load the sound alias prefix.
-        if (handler[7] != ADDRESS_MISSING)
+        if (sndAliasPrefix_p != ADDRESS_MISSING)
         {
-            if (handler[7] != ADDRESS_FOLLOWING)
+            if (sndAliasPrefix_p != ADDRESS_FOLLOWING)
             {
-                sndAliasPrefix = ff->GetPointer(handler[7]);
+                sndAliasPrefix = ff->GetPointer<Policy>(sndAliasPrefix_p);
             }
             else
             {
                 // Read the sound alias prefix.
-                sndAliasPrefix = ff->ReadSharedString(64);
+                sndAliasPrefix = ff->ReadSharedString();
             }
         }
         else
@@ -105,8 +115,18 @@ void Physpreset::Load(class FastFile *ff, address_t *handle)
             sndAliasPrefix = nullptr;
         }
     }
+}
 
-    Store(ff, handle);
+void Physpreset::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
 }
 
 void Physpreset::Store(class FastFile *ff, address_t *handle)
@@ -115,6 +135,28 @@ void Physpreset::Store(class FastFile *ff, address_t *handle)
     UNREFERENCED_PARAMETER(handle);
 }
 
+/**
+ * Prints the values of the physpreset.
+ */
+void Physpreset::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    VERBOSE("\nPYSPRESET\n\t%-32s%s\n\t%-32s%s\n\t%-32s%f\n\t%-32s0x%08X\n\t%-32s%i\n\t%-32s%f\n\t%-32s%f\n\t%-32s%f\n\t%-32s%f\n\t%-32s%f\n\t%-32s%i\n",
+        "name", name,
+        "sndAliasPrefix", sndAliasPrefix,
+        "mass", mass,
+        "friction", friction,
+        "isFrictionInfinity", isFrictionInfinity,
+        "bounce", bounce,
+        "bulletForceScale", bulletForceScale,
+        "explosiveForceScale", explosiveForceScale,
+        "piecesSpreadFraction", piecesSpreadFraction,
+        "piecesUpwardVelocity", piecesUpwardVelocity,
+        "tempDefaultToCylinder", tempDefaultToCylinder
+    );
+}
+
 /**
  * FORMAT DOCUMENTATION
  * [00] int32       name_p
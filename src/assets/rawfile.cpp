@@ -23,11 +23,18 @@ void Rawfile::Release(void) noexcept
     data_s = 0;
 }
 
+const char* Rawfile::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
 void Rawfile::Load(class FastFile *ff, address_t *handle)
 {
-    address_t handler[3];
+    const address_t *handler;
+    address_t name_p, data_p;
 
-    ASSERT(
+    CHECK(Policy,
         *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
         "Internal error (0x%08X)",
             *handle
@@ -37,38 +44,40 @@ void Rawfile::Load(class FastFile *ff, address_t *handle)
     if (*handle == ADDRESS_FOLLOWING)
     {
         // Read the rawfile values.
-        ff->ReadMemory(handler, 12);
-        ASSERT(
+        handler = (const address_t*)ff->BorrowMemory(12);
+        CHECK(Policy,
             handler[0] != ADDRESS_MISSING && handler[2] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X)",
                 handler[0]
         );
 
-        // Load the name.
-        if (handler[0] != ADDRESS_FOLLOWING)
-        {
-            name = ff->GetPointer(handler[0]);
-        }
-        else
-        {
-            // Read the name of the raw file.
-            name = ff->ReadSharedString(64);
-        }
-
         // Check the size of the rawfile.
-        ASSERT(
+        CHECK(Policy,
             handler[1] >= 0,
             "Corrupted data. (%i)",
                 handler[1]
         );
 
-        // Store the data size.
+        // The values are gone with the next read.
+        name_p = handler[0];
         data_s = handler[1] + 1; // There is always an additional string terminator
+        data_p = handler[2];
+
+        // Load the name.
+        if (name_p != ADDRESS_FOLLOWING)
+        {
+            name = ff->GetPointer<Policy>(name_p);
+        }
+        else
+        {
+            // Read the name of the raw file.
+            name = ff->ReadSharedString();
+        }
 
         // Load the data.
-        if (handler[2] != ADDRESS_FOLLOWING)
+        if (data_p != ADDRESS_FOLLOWING)
         {
-            data = ff->GetPointer(handler[2]);
+            data = ff->GetPointer<Policy>(data_p);
         }
         else
         {
@@ -76,8 +85,18 @@ void Rawfile::Load(class FastFile *ff, address_t *handle)
             data = (char*)ff->ReadSharedMemory(data_s);
         }
     }
+}
 
-    Store(ff, handle);
+void Rawfile::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
 }
 
 void Rawfile::Store(class FastFile *ff, address_t *handle)
@@ -86,6 +105,17 @@ void Rawfile::Store(class FastFile *ff, address_t *handle)
     UNREFERENCED_PARAMETER(handle);
 }
 
+/**
+ * Prints the name and the data of the raw file.
+ */
+void Rawfile::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    VERBOSE("\nRAWFILE\n\t%s (%i)\n\t%s\n",
+        name, data_s, data);
+}
+
 /**
  * FORMAT DOCUMENTATION
  * [00] int32       name_p
@@ -0,0 +1,147 @@
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "sndcurve.hpp"
+
+SndCurve::SndCurve(void)
+{
+    header = nullptr;
+    name = nullptr;
+}
+
+SndCurve::~SndCurve(void)
+{
+    Release();
+}
+
+void SndCurve::Release(void) noexcept
+{
+    header = nullptr;
+    name = nullptr;
+}
+
+const char* SndCurve::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
+void SndCurve::Load(class FastFile *ff, address_t *handle)
+{
+    struct SndCurveHeader *handler;
+
+    CHECK(Policy,
+        *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
+        "Internal error (0x%08X)",
+            *handle
+    );
+
+    // Only load when the data is there.
+    if (*handle == ADDRESS_FOLLOWING)
+    {
+        // Read the curve values, the knots are within.
+        handler = (struct SndCurveHeader*)ff->ReadSharedMemory(sizeof(struct SndCurveHeader), 4);
+        *handle = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, handler);
+
+        CHECK(Policy,
+            handler->filename != ADDRESS_MISSING,
+            "Corrupted data. (0x%08X)",
+                handler->filename
+        );
+        CHECK(Policy,
+            handler->knotCount >= 0 && handler->knotCount <= SNDCURVE_KNOTS,
+            "Corrupted data. (%i knots)",
+                handler->knotCount
+        );
+
+        // Read the name of the curve.
+        if (handler->filename == ADDRESS_FOLLOWING)
+        {
+            name = ff->ReadSharedString();
+            handler->filename = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, name);
+        }
+        else
+        {
+            name = ff->GetPointer<Policy>(handler->filename);
+        }
+        VERBOSE("sndcurve->name = '%s'\n", name);
+    }
+}
+
+void SndCurve::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
+}
+
+/**
+ * Stores the curve by pointing into the memory of the fast file.
+ * @param handle The handle to the curve in memory.
+ */
+template <class Policy>
+void SndCurve::Store(class FastFile *ff, address_t *handle)
+{
+    CHECK(Policy,
+        *handle != ADDRESS_FOLLOWING,
+        "Corrupted data. (0x%08X)",
+            *handle
+    );
+
+    // Only load the data if there is data.
+    if (*handle != ADDRESS_MISSING)
+    {
+        header = (const struct SndCurveHeader*)ff->GetPointer<Policy>(*handle);
+        name = ff->GetPointer<Policy>(header->filename);
+    }
+}
+
+void SndCurve::Store(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Store<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Store<Checked>(ff, handle);
+    }
+}
+
+void SndCurve::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    VERBOSE("\nSNDCURVE\n\t%-*s%s\n", DUMP_OFFSET, "name", name);
+    for (int i = 0; i < GetKnotCount(); i++)
+    {
+        VERBOSE("\t%-*s%f %f\n", DUMP_OFFSET, "knot", header->knots[i][0], header->knots[i][1]);
+    }
+}
+
+int SndCurve::GetKnotCount(void)
+{
+    return (header != nullptr) ? header->knotCount : 0;
+}
+
+/**
+ * Gets a knot of the curve, its distance and its volume.
+ * @param i The number of the knot.
+ */
+const float* SndCurve::GetKnot(int i)
+{
+    ASSERT(i >= 0 && i < GetKnotCount(), "Knot out of range. (%i)", i);
+
+    return header->knots[i];
+}
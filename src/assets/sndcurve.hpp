@@ -0,0 +1,47 @@
+#ifndef SNDCURVE_HPP
+#define SNDCURVE_HPP
+
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+
+#define SNDCURVE_KNOTS          8
+
+/** The structure as it is within the fast file, see FORMAT DOCUMENTATION. */
+struct SndCurveHeader
+{
+    address_t filename;
+    int knotCount;
+    float knots[SNDCURVE_KNOTS][2];     // Distance and volume, both within [0, 1]
+};
+
+static_assert(sizeof(struct SndCurveHeader) == 0x48, "SndCurve is 72 bytes.");
+
+class SndCurve : public Asset
+{
+public:
+    SndCurve(void);
+    ~SndCurve(void);
+    void Release(void) noexcept;
+    const char* GetName(void);
+
+    void Load(class FastFile *ff, address_t *handle);
+    void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
+
+    int GetKnotCount(void);
+    const float* GetKnot(int i);
+
+private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
+    template <class Policy>
+    void Store(class FastFile *ff, address_t *handle);
+
+ASSET_PROPERTIES:
+    const struct SndCurveHeader *header;
+    char *name;
+};
+
+#endif /* SNDCURVE_HPP */
@@ -0,0 +1,318 @@
+#include <cstdlib>
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "loadedsound.hpp"
+#include "sndcurve.hpp"
+#include "sound.hpp"
+
+Sound::Sound(void)
+{
+    header = nullptr;
+    name = nullptr;
+    entries = nullptr;
+    loadedSounds = nullptr;
+    count = 0;
+}
+
+Sound::~Sound(void)
+{
+    Release();
+}
+
+void Sound::Release(void) noexcept
+{
+    if (entries != nullptr)
+    {
+        free(entries);
+        entries = nullptr;
+    }
+
+    if (loadedSounds != nullptr)
+    {
+        delete[] loadedSounds;
+        loadedSounds = nullptr;
+    }
+
+    header = nullptr;
+    name = nullptr;
+    count = 0;
+}
+
+const char* Sound::GetName(void)
+{
+    return name;
+}
+
+/**
+ * Reads a string when its address says it follows, and replaces the address
+ * by the one the string got.
+ * @param address The address of the string, within the memory.
+ */
+template <class Policy>
+static void ReadName(class FastFile *ff, address_t *address)
+{
+    char *string;
+
+    if (*address == ADDRESS_FOLLOWING)
+    {
+        string = ff->ReadSharedString();
+        *address = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, string);
+    }
+}
+
+template <class Policy>
+void Sound::Load(class FastFile *ff, address_t *handle)
+{
+    struct SoundHeader *handler;
+    struct SoundAlias *aliases;
+
+    CHECK(Policy,
+        *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
+        "Internal error (0x%08X)",
+            *handle
+    );
+
+    // Only load when the data is there.
+    if (*handle == ADDRESS_FOLLOWING)
+    {
+        // Read the alias list values.
+        handler = (struct SoundHeader*)ff->ReadSharedMemory(sizeof(struct SoundHeader), 4);
+        *handle = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, handler);
+
+        CHECK(Policy,
+            handler->aliasName != ADDRESS_MISSING,
+            "Corrupted data. (0x%08X)",
+                handler->aliasName
+        );
+
+        // Read the name of the list.
+        if (handler->aliasName == ADDRESS_FOLLOWING)
+        {
+            name = ff->ReadSharedString();
+            handler->aliasName = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, name);
+        }
+        else
+        {
+            name = ff->GetPointer<Policy>(handler->aliasName);
+        }
+        VERBOSE("sound->name = '%s'\n", name);
+
+        // Read the aliases, each followed by what it points to.
+        aliases = (struct SoundAlias*)ff->ReadArray<Policy>(&handler->head, handler->count * (int)sizeof(struct SoundAlias), 4);
+        if (aliases != nullptr)
+        {
+            for (int i = 0; i < handler->count; i++)
+            {
+                LoadAlias<Policy>(ff, &aliases[i]);
+            }
+        }
+    }
+}
+
+/**
+ * Reads what follows an alias.
+ * @param alias The alias, within the memory.
+ */
+template <class Policy>
+void Sound::LoadAlias(class FastFile *ff, struct SoundAlias *alias)
+{
+    struct SoundFile *file;
+    struct SpeakerMapHeader *map;
+
+    ReadName<Policy>(ff, &alias->aliasName);
+    ReadName<Policy>(ff, &alias->subtitle);
+    ReadName<Policy>(ff, &alias->secondaryAliasName);
+    ReadName<Policy>(ff, &alias->chainAliasName);
+
+    file = (struct SoundFile*)ff->ReadArray<Policy>(&alias->soundFile, sizeof(struct SoundFile), 4);
+    if (file != nullptr)
+    {
+        // The loaded sound may be an asset of its own, kept as an address.
+        if (file->type == SOUND_FILE_LOADED)
+        {
+            if (file->u.loadSnd == ADDRESS_FOLLOWING)
+            {
+                LoadedSound loaded;
+                loaded.Load(ff, &file->u.loadSnd);
+            }
+        }
+        else
+        {
+            ReadName<Policy>(ff, &file->u.streamSnd.dir);
+            ReadName<Policy>(ff, &file->u.streamSnd.name);
+        }
+    }
+
+    // The curve only takes its address, hence the object is not kept.
+    if (alias->volumeFalloffCurve == ADDRESS_FOLLOWING)
+    {
+        SndCurve curve;
+        curve.Load(ff, &alias->volumeFalloffCurve);
+    }
+
+    map = (struct SpeakerMapHeader*)ff->ReadArray<Policy>(&alias->speakerMap, sizeof(struct SpeakerMapHeader), 4);
+    if (map != nullptr)
+    {
+        ReadName<Policy>(ff, &map->name);
+    }
+}
+
+void Sound::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
+}
+
+/**
+ * Gets a string by its address, which may be missing.
+ */
+template <class Policy>
+static const char* GetString(class FastFile *ff, address_t address)
+{
+    return (address != ADDRESS_MISSING) ? ff->GetPointer<Policy>(address) : nullptr;
+}
+
+/**
+ * Stores the alias list by pointing into the memory of the fast file. The
+ * entries are allocated, as are the loaded sounds of the aliases.
+ * @param handle The handle to the alias list in memory.
+ */
+template <class Policy>
+void Sound::Store(class FastFile *ff, address_t *handle)
+{
+    struct Span<struct SoundAlias> aliases;
+    struct SoundEntry *entry;
+    address_t loadSnd;
+
+    CHECK(Policy,
+        *handle != ADDRESS_FOLLOWING,
+        "Corrupted data. (0x%08X)",
+            *handle
+    );
+
+    // Only load the data if there is data.
+    if (*handle != ADDRESS_MISSING)
+    {
+        header = (const struct SoundHeader*)ff->GetPointer<Policy>(*handle);
+        name = ff->GetPointer<Policy>(header->aliasName);
+
+        ff->GetSpan<Policy>(header->head, header->count, &aliases);
+        if (aliases.count > 0)
+        {
+            entries = (struct SoundEntry*)calloc(aliases.count, sizeof(struct SoundEntry));
+            if (entries == nullptr)
+            {
+                throw std::exception("Out of memory (sound)");
+            }
+            loadedSounds = new LoadedSound[aliases.count];
+            count = aliases.count;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            const struct SoundAlias *alias = &aliases.data[i];
+
+            entry = &entries[i];
+            entry->alias = alias;
+            entry->aliasName = GetString<Policy>(ff, alias->aliasName);
+            entry->subtitle = GetString<Policy>(ff, alias->subtitle);
+            entry->secondaryAliasName = GetString<Policy>(ff, alias->secondaryAliasName);
+            entry->chainAliasName = GetString<Policy>(ff, alias->chainAliasName);
+
+            if (alias->soundFile != ADDRESS_MISSING)
+            {
+                entry->file = (const struct SoundFile*)ff->GetPointer<Policy>(alias->soundFile);
+                if (entry->file->type == SOUND_FILE_LOADED && entry->file->u.loadSnd != ADDRESS_MISSING)
+                {
+                    loadSnd = entry->file->u.loadSnd;
+                    loadedSounds[i].Store(ff, &loadSnd);
+                    entry->loaded = &loadedSounds[i];
+                }
+                else if (entry->file->type != SOUND_FILE_LOADED)
+                {
+                    entry->streamedDir = GetString<Policy>(ff, entry->file->u.streamSnd.dir);
+                    entry->streamedName = GetString<Policy>(ff, entry->file->u.streamSnd.name);
+                }
+            }
+
+            if (alias->volumeFalloffCurve != ADDRESS_MISSING)
+            {
+                entry->volumeFalloffCurve = (const struct SndCurveHeader*)ff->GetPointer<Policy>(alias->volumeFalloffCurve);
+            }
+
+            if (alias->speakerMap != ADDRESS_MISSING)
+            {
+                entry->speakerMap = (const struct SpeakerMapHeader*)ff->GetPointer<Policy>(alias->speakerMap);
+                entry->speakerMapName = GetString<Policy>(ff, entry->speakerMap->name);
+            }
+        }
+    }
+}
+
+void Sound::Store(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Store<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Store<Checked>(ff, handle);
+    }
+}
+
+void Sound::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    VERBOSE("\nSOUND\n\t%-*s%s\n\t%-*s%i\n", DUMP_OFFSET, "name", name, DUMP_OFFSET, "aliases", count);
+    for (int i = 0; i < count; i++)
+    {
+        VERBOSE("\t%-*s%i %s\n", DUMP_OFFSET, "alias", i,
+            (entries[i].loaded != nullptr) ? entries[i].loaded->GetName() :
+                (entries[i].streamedName != nullptr) ? entries[i].streamedName : "(none)");
+    }
+}
+
+int Sound::GetAliasCount(void)
+{
+    return count;
+}
+
+/**
+ * Gets an alias of the list, with its names and its sound file.
+ * @param i The number of the alias.
+ */
+const struct SoundEntry* Sound::GetAlias(int i)
+{
+    ASSERT(i >= 0 && i < count, "Alias out of range. (%i)", i);
+
+    return &entries[i];
+}
+
+/**
+ * Exports the loaded sounds of the aliases, see LoadedSound::Export.
+ */
+void Sound::Export(class FastFile *ff, class Exporter *exporter)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (entries[i].loaded != nullptr)
+        {
+            entries[i].loaded->Export(ff, exporter);
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef SOUND_HPP
+#define SOUND_HPP
+
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "loadedsound.hpp"
+#include "sndcurve.hpp"
+
+#define SOUND_FILE_LOADED       1
+#define SOUND_FILE_STREAMED     2
+#define SOUND_SPEAKERS          6
+
+/*
+ * The structures as they are within the fast file, see FORMAT DOCUMENTATION.
+ * Pointers are addresses, which Store translates.
+ */
+
+struct SoundFile
+{
+    unsigned char type;                 // SOUND_FILE_*
+    unsigned char exists;
+    union
+    {
+        address_t loadSnd;              // A loaded sound
+        struct
+        {
+            address_t dir;
+            address_t name;
+        } streamSnd;
+    } u;
+};
+
+struct SpeakerLevels
+{
+    int speaker;
+    int numLevels;
+    float levels[2];
+};
+
+struct ChannelMap
+{
+    int speakerCount;
+    struct SpeakerLevels speakers[SOUND_SPEAKERS];
+};
+
+struct SpeakerMapHeader
+{
+    unsigned char isDefault;
+    address_t name;
+    struct ChannelMap channelMaps[2][2];    // By the channels of the source and of the output
+};
+
+struct SoundAlias
+{
+    address_t aliasName;
+    address_t subtitle;
+    address_t secondaryAliasName;
+    address_t chainAliasName;
+    address_t soundFile;
+    int sequence;
+    float volMin;
+    float volMax;
+    float pitchMin;
+    float pitchMax;
+    float distMin;
+    float distMax;
+    int flags;
+    float slavePercentage;
+    float probability;
+    float lfePercentage;
+    float centerPercentage;
+    int startDelay;
+    address_t volumeFalloffCurve;       // A sound curve
+    float envelopMin;
+    float envelopMax;
+    float envelopPercentage;
+    address_t speakerMap;
+};
+
+struct SoundHeader
+{
+    address_t aliasName;
+    address_t head;
+    int count;
+};
+
+static_assert(sizeof(struct SoundFile) == 0x0C, "SoundFile is 12 bytes.");
+static_assert(sizeof(struct SpeakerMapHeader) == 0x198, "SpeakerMap is 408 bytes.");
+static_assert(sizeof(struct SoundAlias) == 0x5C, "snd_alias_t is 92 bytes.");
+static_assert(sizeof(struct SoundHeader) == 0x0C, "snd_alias_list_t is 12 bytes.");
+
+/**
+ * An alias of the list, with its names looked up. Its file is either loaded,
+ * then its samples are within the fast file, or streamed from a directory.
+ */
+struct SoundEntry
+{
+    const struct SoundAlias *alias;
+    const char *aliasName;
+    const char *subtitle;
+    const char *secondaryAliasName;
+    const char *chainAliasName;
+    const struct SoundFile *file;
+    class LoadedSound *loaded;          // When the file is loaded
+    const char *streamedDir;            // When the file is streamed
+    const char *streamedName;
+    const struct SndCurveHeader *volumeFalloffCurve;
+    const struct SpeakerMapHeader *speakerMap;
+    const char *speakerMapName;
+};
+
+class Sound : public Asset
+{
+public:
+    Sound(void);
+    ~Sound(void);
+    void Release(void) noexcept;
+    const char* GetName(void);
+
+    void Load(class FastFile *ff, address_t *handle);
+    void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
+    void Export(class FastFile *ff, class Exporter *exporter);
+
+    int GetAliasCount(void);
+    const struct SoundEntry* GetAlias(int i);
+
+private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
+    template <class Policy>
+    void LoadAlias(class FastFile *ff, struct SoundAlias *alias);
+    template <class Policy>
+    void Store(class FastFile *ff, address_t *handle);
+
+ASSET_PROPERTIES:
+    const struct SoundHeader *header;
+    char *name;
+    struct SoundEntry *entries;
+    class LoadedSound *loadedSounds;    // One per alias, stored when it is loaded
+    int count;
+};
+
+#endif /* SOUND_HPP */
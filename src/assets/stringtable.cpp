@@ -30,6 +30,12 @@ void Stringtable::Release(void) noexcept
     }
 }
 
+const char* Stringtable::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
 void Stringtable::Load(class FastFile *ff, address_t *handle)
 {
     union
@@ -38,7 +44,7 @@ void Stringtable::Load(class FastFile *ff, address_t *handle)
         int *values;
     };
 
-    ASSERT(
+    CHECK(Policy,
         *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
         "Internal error (0x%08X)",
             *handle
@@ -49,9 +55,9 @@ void Stringtable::Load(class FastFile *ff, address_t *handle)
     {
         // Read the stringtable values.
         handler = (address_t*)ff->ReadSharedMemory(4*4, 4);
-        *handle = ff->GetAddress(4, handler);
+        *handle = ff->GetAddress<Policy>(4, handler);
 
-        ASSERT(
+        CHECK(Policy,
             handler[0] != ADDRESS_MISSING && handler[3] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X, 0x%08X)",
                 handler[0], handler[3]
@@ -60,15 +66,19 @@ void Stringtable::Load(class FastFile *ff, address_t *handle)
         // Read the name of the string table.
         if (handler[0] == ADDRESS_FOLLOWING)
         {
-            char *name = (char*)ff->ReadSharedString(64);
-            handler[0] = ff->GetAddress(4, name);
+            name = ff->ReadSharedString();
+            handler[0] = ff->GetAddress<Policy>(4, name);
+        }
+        else
+        {
+            name = ff->GetPointer<Policy>(handler[0]);
         }
 
         // NOTE: I don't know the exact min/max, but these seem to be it.
-        ASSERT(values[1] >= 0x01 && values[2] >= 0x01,
+        CHECK(Policy, values[1] >= 0x01 && values[2] >= 0x01,
             "Stringtable size out of bounds. (%i, %i)", 
                 values[1], values[2]);
-        ASSERT(values[1] <= 0xFF && values[2] <= 0xFF,
+        CHECK(Policy, values[1] <= 0xFF && values[2] <= 0xFF,
             "Stringtable size out of bounds. (%i, %i)",
                 values[1], values[2]);
 
@@ -83,7 +93,7 @@ void Stringtable::Load(class FastFile *ff, address_t *handle)
 
             // Store the fast file address of the stringtable index.
             index = (address_t*)ff->ReadSharedMemory((index_s * 4), 4);
-            handler[3] = ff->GetAddress(4, index);
+            handler[3] = ff->GetAddress<Policy>(4, index);
 
             // Copy each string and store their values.
             for (int i = 0; i < index_s; i++)
@@ -92,20 +102,31 @@ void Stringtable::Load(class FastFile *ff, address_t *handle)
                 if (index[i] == ADDRESS_FOLLOWING)
                 {
                     // Copy the string.
-                    char *value = ff->ReadSharedString(64);
-                    index[i] = ff->GetAddress(4, value);
+                    char *value = ff->ReadSharedString();
+                    index[i] = ff->GetAddress<Policy>(4, value);
                 }
             }
         }
     }
+}
 
-    Store(ff, handle);
+void Stringtable::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
 }
 
 /**
  * Stores the data from memory in a 64-bit compatible way in the class object.
  * @param handle The handle to the stringtable in memory.
  */
+template <class Policy>
 void Stringtable::Store(class FastFile *ff, address_t *handle)
 {
     union
@@ -115,7 +136,7 @@ void Stringtable::Store(class FastFile *ff, address_t *handle)
     };
     address_t *index;
 
-    ASSERT(
+    CHECK(Policy,
         *handle != ADDRESS_FOLLOWING,
         "Corrupted data. (0x%08X)",
             *handle
@@ -125,15 +146,15 @@ void Stringtable::Store(class FastFile *ff, address_t *handle)
     if (*handle != ADDRESS_MISSING)
     {
         // Gets the pointer to the string table in memory.
-        handler = (address_t*)ff->GetPointer(*handle);
+        handler = (address_t*)ff->GetPointer<Policy>(*handle);
 
         // Store simple types first.
-        name = ff->GetPointer(handler[0]);
+        name = ff->GetPointer<Policy>(handler[0]);
         columns = values[1];
         rows = values[2];
 
         // Get the pointer to the cells index.
-        index = (address_t*)ff->GetPointer(handler[3]);
+        index = (address_t*)ff->GetPointer<Policy>(handler[3]);
 
         // Allocate room for the cells.
         cells = (char**)calloc(columns * rows, sizeof(char*));
@@ -142,25 +163,51 @@ void Stringtable::Store(class FastFile *ff, address_t *handle)
             throw std::exception("Out of memory (stringtable)");
         }
 
-        // Translate all the cell pointers.
-        for (int y = 0; y < rows; y++)
-        {
-            for (int x = 0; x < columns; x++)
-            {
-                int z = ((y * columns) + x);
+        // Translate all the cell pointers at once.
+        ff->TranslateAddresses<Policy>(index, (columns * rows), cells);
+    }
+}
+
+void Stringtable::Store(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Store<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Store<Checked>(ff, handle);
+    }
+}
 
-                ASSERT(
-                    index[z] != ADDRESS_FOLLOWING,
-                    "Corrupted data. (0x%08X)",
-                        index[z]
-                );
+/**
+ * Prints the cells of the stringtable as CSV.
+ */
+void Stringtable::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
 
-                if (index[z] != ADDRESS_MISSING)
-                {
-                    cells[z] = ff->GetPointer(index[z]);
-                }
+    VERBOSE("\nSTRINGTABLE\n");
+
+    for (int y = 0; y < rows; y++)
+    {
+        fputc('\t', stderr);
+
+        for (int x = 0; x < columns; x++)
+        {
+            int z = ((y * columns) + x);
+
+            if (x == 0)
+            {
+                VERBOSE("%s", cells[z]);
+            }
+            else
+            {
+                VERBOSE(",%s", cells[z]);
             }
         }
+
+        fputc('\n', stderr);
     }
 }
 
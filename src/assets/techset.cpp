@@ -23,12 +23,19 @@ void Techset::Release(void) noexcept
     name = nullptr;
 }
 
+const char* Techset::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
 void Techset::Load(class FastFile *ff, address_t *handle)
 {
-    address_t handler[37];
+    const address_t *handler;
+    address_t name_p;
 
 #ifdef HANDLE_CHECK
-    ASSERT(
+    CHECK(Policy,
         *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
         "Internal error (0x%08X)",
             *handle
@@ -39,43 +46,54 @@ void Techset::Load(class FastFile *ff, address_t *handle)
     if (*handle == ADDRESS_FOLLOWING)
     {
         // Read the techset values.
-        ff->ReadMemory(handler, 37*4);
-        ASSERT(
+        handler = (const address_t*)ff->BorrowMemory(37*4);
+        CHECK(Policy,
             handler[0] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X)",
                 handler[0]
         );
-        ASSERT(
+        CHECK(Policy,
             handler[1] == 0 && handler[2] == 0,
             "Corrupted data. (0x%08X, 0x%08X)",
                 handler[1], handler[2]
         );
 
+        // Read the technique handlers, before the next read.
+        memcpy(techniques, (handler + 3), (MAX_TECHNIQUES * 4));
+        name_p = handler[0];
+
         // Read the techset name.
-        if (handler[0] != ADDRESS_FOLLOWING)
+        if (name_p != ADDRESS_FOLLOWING)
         {
-            name = ff->GetPointer(handler[0]);
+            name = ff->GetPointer<Policy>(name_p);
         }
         else
         {
             // Read the name of the techset.
-            name = ff->ReadSharedString(64);
+            name = ff->ReadSharedString();
         }
 
-        // Read the technique handlers.
-        //ff->ReadMemory(techniques, MAX_TECHNIQUES*4);
-        memcpy(techniques, (handler + 3), (MAX_TECHNIQUES * 4));
-
         // Load all the individual techniques.
         for (int i = 0; i < MAX_TECHNIQUES; i++)
         {
-            LoadTechnique(ff, (techniques + i));
+            LoadTechnique<Policy>(ff, (techniques + i));
         }
     }
+}
 
-    Store(ff, handle);
+void Techset::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
 }
 
+template <class Policy>
 void Techset::LoadTechnique(class FastFile *ff, address_t *handle)
 {
     address_t *handler = nullptr;
@@ -84,43 +102,44 @@ void Techset::LoadTechnique(class FastFile *ff, address_t *handle)
     {
         // Read the technique values.
         handler = (address_t*)ff->ReadSharedMemory(7*4, 4);
-        *handle = ff->GetAddress(4, handler);
+        *handle = ff->GetAddress<Policy>(4, handler);
 
-        ASSERT(
+        CHECK(Policy,
             handler[0] != ADDRESS_MISSING,
             "Corrupted data. (0x%08X)",
                 handler[0]
         );
 
-        ASSERT(
+        CHECK(Policy,
             ((handler[1] >> 16) & 0xFFFF) == 1,
             "Corrupted data. (0x%08X)",
                 handler[1]
         );
 
         // Technique dependencies
-        LoadStateMap(ff, (handler + 2));
-        LoadShader(ff, (handler + 3));
-        LoadShader(ff, (handler + 4));
-        LoadBinds(ff, (handler + 6), handler[5], 0);
+        LoadStateMap<Policy>(ff, (handler + 2));
+        LoadShader<Policy>(ff, (handler + 3));
+        LoadShader<Policy>(ff, (handler + 4));
+        LoadBinds<Policy>(ff, (handler + 6), handler[5], 0);
 
         // Load the name.
         if (handler[0] == ADDRESS_FOLLOWING)
         {
             // Read the name of the technique.
-            char *name = ff->ReadSharedString(64);
-            handler[0] = ff->GetAddress(4, name);
+            char *name = ff->ReadSharedString();
+            handler[0] = ff->GetAddress<Policy>(4, name);
         }
     }
 }
 
 /** TODO: FIXME: NOTE: The order may not be correct, needs to be fixed later. */
+template <class Policy>
 void Techset::LoadStateMap(class FastFile *ff, address_t *handle)
 {
     int *map;
 
 #ifdef HANDLE_CHECK
-    ASSERT(
+    CHECK(Policy,
         *handle != ADDRESS_MISSING,
         "Corrupted data. (0x%08X)",
             *handle
@@ -132,16 +151,17 @@ void Techset::LoadStateMap(class FastFile *ff, address_t *handle)
     {
         // Load the state map.
         map = (int*)ff->ReadSharedMemory(100, 4);
-        *handle = ff->GetAddress(4, map);
+        *handle = ff->GetAddress<Policy>(4, map);
     }
 }
 
+template <class Policy>
 void Techset::LoadShader(class FastFile *ff, address_t *handle)
 {
     int *handler;
 
 #ifdef HANDLE_CHECK
-    ASSERT(
+    CHECK(Policy,
         *handle != ADDRESS_MISSING,
         "Corrupted data. (0x%08X)",
             *handle
@@ -152,9 +172,9 @@ void Techset::LoadShader(class FastFile *ff, address_t *handle)
     {
         // Read the shader values.
         handler = (int*)ff->ReadSharedMemory(4*4, 4);
-        *handle = ff->GetAddress(4, handler);
+        *handle = ff->GetAddress<Policy>(4, handler);
 
-        ASSERT(
+        CHECK(Policy,
             handler[0] != 0 && handler[1] == 0 && handler[2] != 0,
             "Corrupted data. (0x%08X, 0x%08X, 0x%08X)",
                 handler[0], handler[1], handler[2]
@@ -164,8 +184,8 @@ void Techset::LoadShader(class FastFile *ff, address_t *handle)
         if (handler[0] == ADDRESS_FOLLOWING)
         {
             // Read the name of the shader.
-            char *name = ff->ReadSharedString(64);
-            handler[0] = ff->GetAddress(4, name);
+            char *name = ff->ReadSharedString();
+            handler[0] = ff->GetAddress<Policy>(4, name);
         }
 
         // Load the shader data.
@@ -176,11 +196,12 @@ void Techset::LoadShader(class FastFile *ff, address_t *handle)
 
             // Read the data of the shader.
             int *data = (int*)ff->ReadSharedMemory(data_s, 4);
-            handler[2] = ff->GetAddress(4, data);
+            handler[2] = ff->GetAddress<Policy>(4, data);
         }
     }
 }
 
+template <class Policy>
 void Techset::LoadBinds(class FastFile *ff, address_t *handle, int bindInfo, int flags)
 {
     int count =
@@ -192,7 +213,7 @@ void Techset::LoadBinds(class FastFile *ff, address_t *handle, int bindInfo, int
     {
         // Load the bindings.
         void *binds = ff->ReadSharedMemory(count, 4);
-        *handle = ff->GetAddress(4, binds);
+        *handle = ff->GetAddress<Policy>(4, binds);
 
         // Bindings may contain an extension.
         address_t *extension = (address_t*)(((char*)binds) + count - 4);
@@ -200,7 +221,7 @@ void Techset::LoadBinds(class FastFile *ff, address_t *handle, int bindInfo, int
         {
             // Load the extension
             void *data = ff->ReadSharedMemory(16, -1);
-            *extension = ff->GetAddress(4, data);
+            *extension = ff->GetAddress<Policy>(4, data);
         }
     }
 }
@@ -211,6 +232,66 @@ void Techset::Store(class FastFile *ff, address_t *handle)
     UNREFERENCED_PARAMETER(handle);
 }
 
+/**
+ * Prints the name of the techset and the names of its techniques.
+ */
+void Techset::Dump(class FastFile *ff)
+{
+    VERBOSE("\nTECHSET\n\t%-*s%s\n", DUMP_OFFSET, "techset", name);
+
+    for (int j = 0; j < MAX_TECHNIQUES; j++)
+    {
+        address_t *address_p, address;
+        bool validAddress = false;
+
+        address = techniques[j];
+        VERBOSE("\t%-32s", lpTechSetName[j]);
+
+        if (address != ADDRESS_MISSING)
+        {
+            if (ff->IsValidAddress(address))
+            {
+                address_p = (address_t*)ff->GetPointer(address);
+
+                if (*address_p != ADDRESS_MISSING)
+                {
+                    if (ff->IsValidAddress(*address_p))
+                    {
+                        char *techName = ff->GetPointer(*address_p);
+
+                        if (techName[0] != 0)
+                        {
+                            VERBOSE("%s\n", techName);
+                            validAddress = true;
+                        }
+                    }
+                }
+                else
+                {
+                    validAddress = true;
+                    VERBOSE("<null>\n");
+                }
+
+                if (!validAddress)
+                {
+                    VERBOSE("<error>\n");
+                    validAddress = true; // The other was valid
+                }
+            }
+        }
+        else
+        {
+            validAddress = true;
+            VERBOSE("<null>\n");
+        }
+
+        if (!validAddress)
+        {
+            VERBOSE("<error>\n");
+        }
+    }
+}
+
 
 const char *lpTechSetName[MAX_TECHNIQUES] = {
 
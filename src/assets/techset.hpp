@@ -37,14 +37,22 @@ public:
     Techset(void);
     ~Techset(void);
     void Release(void) noexcept;
+    const char* GetName(void);
 
     void Load(class FastFile *ff, address_t *handle);
     void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
 
 private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
+    template <class Policy>
     void LoadTechnique(class FastFile *ff, address_t *handle);
+    template <class Policy>
     void LoadStateMap(class FastFile *ff, address_t *handle);
+    template <class Policy>
     void LoadShader(class FastFile *ff, address_t *handle);
+    template <class Policy>
     void LoadBinds(class FastFile *ff, address_t *handle, int bindInfo, int flags);
 
 ASSET_PROPERTIES:
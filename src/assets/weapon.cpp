@@ -0,0 +1,899 @@
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "../writer.hpp"
+#include "../exporter.hpp"
+#include "weapon.hpp"
+
+#define WEAPON_COLUMN(field, kind) \
+    { #field, (unsigned short)offsetof(struct WeaponHeader, field), \
+        (unsigned char)(sizeof(WeaponHeader::field) / (((kind) == WEAPON_TAG) ? 2 : 4)), (kind) }
+
+/** The fields of the weapon in the order of the fast file, its data follows in that order. */
+static const struct WeaponColumn weaponColumns[] =
+{
+    WEAPON_COLUMN(szInternalName, WEAPON_STRING),
+    WEAPON_COLUMN(szDisplayName, WEAPON_STRING),
+    WEAPON_COLUMN(szOverlayName, WEAPON_STRING),
+    WEAPON_COLUMN(gunXModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(handXModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(szXAnims, WEAPON_STRING),
+    WEAPON_COLUMN(szModeName, WEAPON_STRING),
+    WEAPON_COLUMN(hideTags, WEAPON_TAG),
+    WEAPON_COLUMN(notetrackSoundMapKeys, WEAPON_TAG),
+    WEAPON_COLUMN(notetrackSoundMapValues, WEAPON_TAG),
+    WEAPON_COLUMN(playerAnimType, WEAPON_INT),
+    WEAPON_COLUMN(weapType, WEAPON_INT),
+    WEAPON_COLUMN(weapClass, WEAPON_INT),
+    WEAPON_COLUMN(penetrateType, WEAPON_INT),
+    WEAPON_COLUMN(impactType, WEAPON_INT),
+    WEAPON_COLUMN(inventoryType, WEAPON_INT),
+    WEAPON_COLUMN(fireType, WEAPON_INT),
+    WEAPON_COLUMN(offhandClass, WEAPON_INT),
+    WEAPON_COLUMN(stance, WEAPON_INT),
+    WEAPON_COLUMN(viewFlashEffect, WEAPON_FX),
+    WEAPON_COLUMN(worldFlashEffect, WEAPON_FX),
+    WEAPON_COLUMN(pickupSound, WEAPON_SOUND),
+    WEAPON_COLUMN(pickupSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(ammoPickupSound, WEAPON_SOUND),
+    WEAPON_COLUMN(ammoPickupSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(projectileSound, WEAPON_SOUND),
+    WEAPON_COLUMN(pullbackSound, WEAPON_SOUND),
+    WEAPON_COLUMN(pullbackSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(fireSound, WEAPON_SOUND),
+    WEAPON_COLUMN(fireSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(fireLoopSound, WEAPON_SOUND),
+    WEAPON_COLUMN(fireLoopSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(fireStopSound, WEAPON_SOUND),
+    WEAPON_COLUMN(fireStopSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(fireLastSound, WEAPON_SOUND),
+    WEAPON_COLUMN(fireLastSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(emptyFireSound, WEAPON_SOUND),
+    WEAPON_COLUMN(emptyFireSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(meleeSwipeSound, WEAPON_SOUND),
+    WEAPON_COLUMN(meleeSwipeSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(meleeHitSound, WEAPON_SOUND),
+    WEAPON_COLUMN(meleeMissSound, WEAPON_SOUND),
+    WEAPON_COLUMN(rechamberSound, WEAPON_SOUND),
+    WEAPON_COLUMN(rechamberSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadSound, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadEmptySound, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadEmptySoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadStartSound, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadStartSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadEndSound, WEAPON_SOUND),
+    WEAPON_COLUMN(reloadEndSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(detonateSound, WEAPON_SOUND),
+    WEAPON_COLUMN(detonateSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(nightVisionWearSound, WEAPON_SOUND),
+    WEAPON_COLUMN(nightVisionWearSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(nightVisionRemoveSound, WEAPON_SOUND),
+    WEAPON_COLUMN(nightVisionRemoveSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(altSwitchSound, WEAPON_SOUND),
+    WEAPON_COLUMN(altSwitchSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(raiseSound, WEAPON_SOUND),
+    WEAPON_COLUMN(raiseSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(firstRaiseSound, WEAPON_SOUND),
+    WEAPON_COLUMN(firstRaiseSoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(putawaySound, WEAPON_SOUND),
+    WEAPON_COLUMN(putawaySoundPlayer, WEAPON_SOUND),
+    WEAPON_COLUMN(bounceSound, WEAPON_SOUNDS),
+    WEAPON_COLUMN(viewShellEjectEffect, WEAPON_FX),
+    WEAPON_COLUMN(worldShellEjectEffect, WEAPON_FX),
+    WEAPON_COLUMN(viewLastShotEjectEffect, WEAPON_FX),
+    WEAPON_COLUMN(worldLastShotEjectEffect, WEAPON_FX),
+    WEAPON_COLUMN(reticleCenter, WEAPON_MATERIAL),
+    WEAPON_COLUMN(reticleSide, WEAPON_MATERIAL),
+    WEAPON_COLUMN(iReticleCenterSize, WEAPON_INT),
+    WEAPON_COLUMN(iReticleSideSize, WEAPON_INT),
+    WEAPON_COLUMN(iReticleMinOfs, WEAPON_INT),
+    WEAPON_COLUMN(activeReticleType, WEAPON_INT),
+    WEAPON_COLUMN(vStandMove, WEAPON_FLOAT),
+    WEAPON_COLUMN(vStandRot, WEAPON_FLOAT),
+    WEAPON_COLUMN(vDuckedOfs, WEAPON_FLOAT),
+    WEAPON_COLUMN(vDuckedMove, WEAPON_FLOAT),
+    WEAPON_COLUMN(vDuckedRot, WEAPON_FLOAT),
+    WEAPON_COLUMN(vProneOfs, WEAPON_FLOAT),
+    WEAPON_COLUMN(vProneMove, WEAPON_FLOAT),
+    WEAPON_COLUMN(vProneRot, WEAPON_FLOAT),
+    WEAPON_COLUMN(fPosMoveRate, WEAPON_FLOAT),
+    WEAPON_COLUMN(fPosProneMoveRate, WEAPON_FLOAT),
+    WEAPON_COLUMN(fStandMoveMinSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fDuckedMoveMinSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fProneMoveMinSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fPosRotRate, WEAPON_FLOAT),
+    WEAPON_COLUMN(fPosProneRotRate, WEAPON_FLOAT),
+    WEAPON_COLUMN(fStandRotMinSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fDuckedRotMinSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fProneRotMinSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(worldModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(worldClipModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(rocketModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(knifeModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(worldKnifeModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(hudIcon, WEAPON_MATERIAL),
+    WEAPON_COLUMN(hudIconRatio, WEAPON_INT),
+    WEAPON_COLUMN(ammoCounterIcon, WEAPON_MATERIAL),
+    WEAPON_COLUMN(ammoCounterIconRatio, WEAPON_INT),
+    WEAPON_COLUMN(ammoCounterClip, WEAPON_INT),
+    WEAPON_COLUMN(iStartAmmo, WEAPON_INT),
+    WEAPON_COLUMN(szAmmoName, WEAPON_STRING),
+    WEAPON_COLUMN(iAmmoIndex, WEAPON_INT),
+    WEAPON_COLUMN(szClipName, WEAPON_STRING),
+    WEAPON_COLUMN(iClipIndex, WEAPON_INT),
+    WEAPON_COLUMN(iMaxAmmo, WEAPON_INT),
+    WEAPON_COLUMN(iClipSize, WEAPON_INT),
+    WEAPON_COLUMN(shotCount, WEAPON_INT),
+    WEAPON_COLUMN(szSharedAmmoCapName, WEAPON_STRING),
+    WEAPON_COLUMN(iSharedAmmoCapIndex, WEAPON_INT),
+    WEAPON_COLUMN(iSharedAmmoCap, WEAPON_INT),
+    WEAPON_COLUMN(damage, WEAPON_INT),
+    WEAPON_COLUMN(playerDamage, WEAPON_INT),
+    WEAPON_COLUMN(iMeleeDamage, WEAPON_INT),
+    WEAPON_COLUMN(iDamageType, WEAPON_INT),
+    WEAPON_COLUMN(iFireDelay, WEAPON_INT),
+    WEAPON_COLUMN(iMeleeDelay, WEAPON_INT),
+    WEAPON_COLUMN(meleeChargeDelay, WEAPON_INT),
+    WEAPON_COLUMN(iDetonateDelay, WEAPON_INT),
+    WEAPON_COLUMN(iFireTime, WEAPON_INT),
+    WEAPON_COLUMN(iRechamberTime, WEAPON_INT),
+    WEAPON_COLUMN(iRechamberBoltTime, WEAPON_INT),
+    WEAPON_COLUMN(iHoldFireTime, WEAPON_INT),
+    WEAPON_COLUMN(iDetonateTime, WEAPON_INT),
+    WEAPON_COLUMN(iMeleeTime, WEAPON_INT),
+    WEAPON_COLUMN(meleeChargeTime, WEAPON_INT),
+    WEAPON_COLUMN(iReloadTime, WEAPON_INT),
+    WEAPON_COLUMN(reloadShowRocketTime, WEAPON_INT),
+    WEAPON_COLUMN(iReloadEmptyTime, WEAPON_INT),
+    WEAPON_COLUMN(iReloadAddTime, WEAPON_INT),
+    WEAPON_COLUMN(iReloadStartTime, WEAPON_INT),
+    WEAPON_COLUMN(iReloadStartAddTime, WEAPON_INT),
+    WEAPON_COLUMN(iReloadEndTime, WEAPON_INT),
+    WEAPON_COLUMN(iDropTime, WEAPON_INT),
+    WEAPON_COLUMN(iRaiseTime, WEAPON_INT),
+    WEAPON_COLUMN(iAltDropTime, WEAPON_INT),
+    WEAPON_COLUMN(iAltRaiseTime, WEAPON_INT),
+    WEAPON_COLUMN(quickDropTime, WEAPON_INT),
+    WEAPON_COLUMN(quickRaiseTime, WEAPON_INT),
+    WEAPON_COLUMN(iFirstRaiseTime, WEAPON_INT),
+    WEAPON_COLUMN(iEmptyRaiseTime, WEAPON_INT),
+    WEAPON_COLUMN(iEmptyDropTime, WEAPON_INT),
+    WEAPON_COLUMN(sprintInTime, WEAPON_INT),
+    WEAPON_COLUMN(sprintLoopTime, WEAPON_INT),
+    WEAPON_COLUMN(sprintOutTime, WEAPON_INT),
+    WEAPON_COLUMN(nightVisionWearTime, WEAPON_INT),
+    WEAPON_COLUMN(nightVisionWearTimeFadeOutEnd, WEAPON_INT),
+    WEAPON_COLUMN(nightVisionWearTimePowerUp, WEAPON_INT),
+    WEAPON_COLUMN(nightVisionRemoveTime, WEAPON_INT),
+    WEAPON_COLUMN(nightVisionRemoveTimePowerDown, WEAPON_INT),
+    WEAPON_COLUMN(nightVisionRemoveTimeFadeInStart, WEAPON_INT),
+    WEAPON_COLUMN(fuseTime, WEAPON_INT),
+    WEAPON_COLUMN(aiFuseTime, WEAPON_INT),
+    WEAPON_COLUMN(requireLockonToFire, WEAPON_INT),
+    WEAPON_COLUMN(noAdsWhenMagEmpty, WEAPON_INT),
+    WEAPON_COLUMN(avoidDropCleanup, WEAPON_INT),
+    WEAPON_COLUMN(autoAimRange, WEAPON_FLOAT),
+    WEAPON_COLUMN(aimAssistRange, WEAPON_FLOAT),
+    WEAPON_COLUMN(aimAssistRangeAds, WEAPON_FLOAT),
+    WEAPON_COLUMN(aimPadding, WEAPON_FLOAT),
+    WEAPON_COLUMN(enemyCrosshairRange, WEAPON_FLOAT),
+    WEAPON_COLUMN(crosshairColorChange, WEAPON_INT),
+    WEAPON_COLUMN(moveSpeedScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsMoveSpeedScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(sprintDurationScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsZoomFov, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsZoomInFrac, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsZoomOutFrac, WEAPON_FLOAT),
+    WEAPON_COLUMN(overlayMaterial, WEAPON_MATERIAL),
+    WEAPON_COLUMN(overlayMaterialLowRes, WEAPON_MATERIAL),
+    WEAPON_COLUMN(overlayReticle, WEAPON_INT),
+    WEAPON_COLUMN(overlayInterface, WEAPON_INT),
+    WEAPON_COLUMN(overlayWidth, WEAPON_FLOAT),
+    WEAPON_COLUMN(overlayHeight, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsBobFactor, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewBobMult, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadStandMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadDuckedMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadProneMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(hipSpreadStandMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(hipSpreadDuckedMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(hipSpreadProneMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadDecayRate, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadFireAdd, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadTurnAdd, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadMoveAdd, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadDuckedDecay, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipSpreadProneDecay, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipReticleSidePos, WEAPON_FLOAT),
+    WEAPON_COLUMN(iAdsTransInTime, WEAPON_INT),
+    WEAPON_COLUMN(iAdsTransOutTime, WEAPON_INT),
+    WEAPON_COLUMN(fAdsIdleAmount, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipIdleAmount, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsIdleSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(hipIdleSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fIdleCrouchFactor, WEAPON_FLOAT),
+    WEAPON_COLUMN(fIdleProneFactor, WEAPON_FLOAT),
+    WEAPON_COLUMN(fGunMaxPitch, WEAPON_FLOAT),
+    WEAPON_COLUMN(fGunMaxYaw, WEAPON_FLOAT),
+    WEAPON_COLUMN(swayMaxAngle, WEAPON_FLOAT),
+    WEAPON_COLUMN(swayLerpSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(swayPitchScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(swayYawScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(swayHorizScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(swayVertScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(swayShellShockScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsSwayMaxAngle, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsSwayLerpSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsSwayPitchScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsSwayYawScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsSwayHorizScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsSwayVertScale, WEAPON_FLOAT),
+    WEAPON_COLUMN(bRifleBullet, WEAPON_INT),
+    WEAPON_COLUMN(armorPiercing, WEAPON_INT),
+    WEAPON_COLUMN(bBoltAction, WEAPON_INT),
+    WEAPON_COLUMN(aimDownSight, WEAPON_INT),
+    WEAPON_COLUMN(bRechamberWhileAds, WEAPON_INT),
+    WEAPON_COLUMN(adsViewErrorMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsViewErrorMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(bCookOffHold, WEAPON_INT),
+    WEAPON_COLUMN(bClipOnly, WEAPON_INT),
+    WEAPON_COLUMN(adsFireOnly, WEAPON_INT),
+    WEAPON_COLUMN(cancelAutoHolsterWhenEmpty, WEAPON_INT),
+    WEAPON_COLUMN(suppressAmmoReserveDisplay, WEAPON_INT),
+    WEAPON_COLUMN(enhanced, WEAPON_INT),
+    WEAPON_COLUMN(laserSightDuringNightvision, WEAPON_INT),
+    WEAPON_COLUMN(killIcon, WEAPON_MATERIAL),
+    WEAPON_COLUMN(killIconRatio, WEAPON_INT),
+    WEAPON_COLUMN(flipKillIcon, WEAPON_INT),
+    WEAPON_COLUMN(dpadIcon, WEAPON_MATERIAL),
+    WEAPON_COLUMN(dpadIconRatio, WEAPON_INT),
+    WEAPON_COLUMN(bNoPartialReload, WEAPON_INT),
+    WEAPON_COLUMN(bSegmentedReload, WEAPON_INT),
+    WEAPON_COLUMN(iReloadAmmoAdd, WEAPON_INT),
+    WEAPON_COLUMN(iReloadStartAdd, WEAPON_INT),
+    WEAPON_COLUMN(szAltWeaponName, WEAPON_STRING),
+    WEAPON_COLUMN(altWeaponIndex, WEAPON_INT),
+    WEAPON_COLUMN(iDropAmmoMin, WEAPON_INT),
+    WEAPON_COLUMN(iDropAmmoMax, WEAPON_INT),
+    WEAPON_COLUMN(blocksProne, WEAPON_INT),
+    WEAPON_COLUMN(silenced, WEAPON_INT),
+    WEAPON_COLUMN(iExplosionRadius, WEAPON_INT),
+    WEAPON_COLUMN(iExplosionRadiusMin, WEAPON_INT),
+    WEAPON_COLUMN(iExplosionInnerDamage, WEAPON_INT),
+    WEAPON_COLUMN(iExplosionOuterDamage, WEAPON_INT),
+    WEAPON_COLUMN(damageConeAngle, WEAPON_FLOAT),
+    WEAPON_COLUMN(iProjectileSpeed, WEAPON_INT),
+    WEAPON_COLUMN(iProjectileSpeedUp, WEAPON_INT),
+    WEAPON_COLUMN(iProjectileSpeedForward, WEAPON_INT),
+    WEAPON_COLUMN(iProjectileActivateDist, WEAPON_INT),
+    WEAPON_COLUMN(projLifetime, WEAPON_FLOAT),
+    WEAPON_COLUMN(timeToAccelerate, WEAPON_FLOAT),
+    WEAPON_COLUMN(projectileCurvature, WEAPON_FLOAT),
+    WEAPON_COLUMN(projectileModel, WEAPON_XMODEL),
+    WEAPON_COLUMN(projExplosion, WEAPON_INT),
+    WEAPON_COLUMN(projExplosionEffect, WEAPON_FX),
+    WEAPON_COLUMN(projExplosionEffectForceNormalUp, WEAPON_INT),
+    WEAPON_COLUMN(projDudEffect, WEAPON_FX),
+    WEAPON_COLUMN(projExplosionSound, WEAPON_SOUND),
+    WEAPON_COLUMN(projDudSound, WEAPON_SOUND),
+    WEAPON_COLUMN(bProjImpactExplode, WEAPON_INT),
+    WEAPON_COLUMN(stickiness, WEAPON_INT),
+    WEAPON_COLUMN(hasDetonator, WEAPON_INT),
+    WEAPON_COLUMN(timedDetonation, WEAPON_INT),
+    WEAPON_COLUMN(rotate, WEAPON_INT),
+    WEAPON_COLUMN(holdButtonToThrow, WEAPON_INT),
+    WEAPON_COLUMN(freezeMovementWhenFiring, WEAPON_INT),
+    WEAPON_COLUMN(lowAmmoWarningThreshold, WEAPON_FLOAT),
+    WEAPON_COLUMN(parallelBounce, WEAPON_FLOAT),
+    WEAPON_COLUMN(perpendicularBounce, WEAPON_FLOAT),
+    WEAPON_COLUMN(projTrailEffect, WEAPON_FX),
+    WEAPON_COLUMN(vProjectileColor, WEAPON_FLOAT),
+    WEAPON_COLUMN(guidedMissileType, WEAPON_INT),
+    WEAPON_COLUMN(maxSteeringAccel, WEAPON_FLOAT),
+    WEAPON_COLUMN(projIgnitionDelay, WEAPON_INT),
+    WEAPON_COLUMN(projIgnitionEffect, WEAPON_FX),
+    WEAPON_COLUMN(projIgnitionSound, WEAPON_SOUND),
+    WEAPON_COLUMN(fAdsAimPitch, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsCrosshairInFrac, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsCrosshairOutFrac, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsGunKickReducedKickBullets, WEAPON_INT),
+    WEAPON_COLUMN(adsGunKickReducedKickPercent, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickPitchMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickPitchMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickYawMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickYawMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickAccel, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickSpeedMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickSpeedDecay, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsGunKickStaticDecay, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewKickPitchMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewKickPitchMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewKickYawMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewKickYawMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewKickCenterSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewScatterMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsViewScatterMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAdsSpread, WEAPON_FLOAT),
+    WEAPON_COLUMN(hipGunKickReducedKickBullets, WEAPON_INT),
+    WEAPON_COLUMN(hipGunKickReducedKickPercent, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickPitchMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickPitchMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickYawMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickYawMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickAccel, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickSpeedMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickSpeedDecay, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipGunKickStaticDecay, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipViewKickPitchMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipViewKickPitchMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipViewKickYawMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipViewKickYawMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipViewKickCenterSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipViewScatterMin, WEAPON_FLOAT),
+    WEAPON_COLUMN(fHipViewScatterMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(fightDist, WEAPON_FLOAT),
+    WEAPON_COLUMN(maxDist, WEAPON_FLOAT),
+    WEAPON_COLUMN(accuracyGraphName, WEAPON_STRING),
+    WEAPON_COLUMN(accuracyGraphKnots, WEAPON_KNOTS),
+    WEAPON_COLUMN(originalAccuracyGraphKnots, WEAPON_KNOTS),
+    WEAPON_COLUMN(accuracyGraphKnotCount, WEAPON_INT),
+    WEAPON_COLUMN(originalAccuracyGraphKnotCount, WEAPON_INT),
+    WEAPON_COLUMN(iPositionReloadTransTime, WEAPON_INT),
+    WEAPON_COLUMN(leftArc, WEAPON_FLOAT),
+    WEAPON_COLUMN(rightArc, WEAPON_FLOAT),
+    WEAPON_COLUMN(topArc, WEAPON_FLOAT),
+    WEAPON_COLUMN(bottomArc, WEAPON_FLOAT),
+    WEAPON_COLUMN(accuracy, WEAPON_FLOAT),
+    WEAPON_COLUMN(aiSpread, WEAPON_FLOAT),
+    WEAPON_COLUMN(playerSpread, WEAPON_FLOAT),
+    WEAPON_COLUMN(minTurnSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(maxTurnSpeed, WEAPON_FLOAT),
+    WEAPON_COLUMN(pitchConvergenceTime, WEAPON_FLOAT),
+    WEAPON_COLUMN(yawConvergenceTime, WEAPON_FLOAT),
+    WEAPON_COLUMN(suppressTime, WEAPON_FLOAT),
+    WEAPON_COLUMN(maxRange, WEAPON_FLOAT),
+    WEAPON_COLUMN(fAnimHorRotateInc, WEAPON_FLOAT),
+    WEAPON_COLUMN(fPlayerPositionDist, WEAPON_FLOAT),
+    WEAPON_COLUMN(szUseHintString, WEAPON_STRING),
+    WEAPON_COLUMN(dropHintString, WEAPON_STRING),
+    WEAPON_COLUMN(iUseHintStringIndex, WEAPON_INT),
+    WEAPON_COLUMN(dropHintStringIndex, WEAPON_INT),
+    WEAPON_COLUMN(horizViewJitter, WEAPON_FLOAT),
+    WEAPON_COLUMN(vertViewJitter, WEAPON_FLOAT),
+    WEAPON_COLUMN(szScript, WEAPON_STRING),
+    WEAPON_COLUMN(fOOPosAnimLength, WEAPON_FLOAT),
+    WEAPON_COLUMN(minDamage, WEAPON_INT),
+    WEAPON_COLUMN(minPlayerDamage, WEAPON_INT),
+    WEAPON_COLUMN(fMaxDamageRange, WEAPON_FLOAT),
+    WEAPON_COLUMN(fMinDamageRange, WEAPON_FLOAT),
+    WEAPON_COLUMN(destabilizationRateTime, WEAPON_FLOAT),
+    WEAPON_COLUMN(destabilizationCurvatureMax, WEAPON_FLOAT),
+    WEAPON_COLUMN(destabilizeDistance, WEAPON_INT),
+    WEAPON_COLUMN(locationDamageMultipliers, WEAPON_FLOAT),
+    WEAPON_COLUMN(fireRumble, WEAPON_STRING),
+    WEAPON_COLUMN(meleeImpactRumble, WEAPON_STRING),
+    WEAPON_COLUMN(adsDofStart, WEAPON_FLOAT),
+    WEAPON_COLUMN(adsDofEnd, WEAPON_FLOAT)
+};
+
+#define WEAPON_COLUMNS          (int)(sizeof(weaponColumns) / sizeof(weaponColumns[0]))
+
+/**
+ * Gets the number of names a column has, each takes a slot of the strings.
+ */
+static int GetSlots(const struct WeaponColumn *column)
+{
+    switch (column->kind)
+    {
+    case WEAPON_TAG:
+    case WEAPON_STRING:
+    case WEAPON_SOUND:
+    case WEAPON_XMODEL:
+    case WEAPON_MATERIAL:
+    case WEAPON_FX:
+        return column->count;
+    case WEAPON_SOUNDS:
+        return WEAPON_SURFACE_TYPES;
+    default:
+        return 0;
+    }
+}
+
+Weapon::Weapon(void)
+{
+    header = nullptr;
+    name = nullptr;
+    strings = nullptr;
+    for (int i = 0; i < (WEAPON_GRAPHS * 2); i++)
+    {
+        knots[i] = { nullptr, 0 };
+    }
+}
+
+Weapon::~Weapon(void)
+{
+    Release();
+}
+
+void Weapon::Release(void) noexcept
+{
+    if (strings != nullptr)
+    {
+        free(strings);
+        strings = nullptr;
+    }
+
+    header = nullptr;
+    name = nullptr;
+    for (int i = 0; i < (WEAPON_GRAPHS * 2); i++)
+    {
+        knots[i] = { nullptr, 0 };
+    }
+}
+
+const char* Weapon::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
+void Weapon::Load(class FastFile *ff, address_t *handle)
+{
+    struct WeaponHeader *handler;
+    const struct WeaponColumn *column;
+    address_t *fields, *sounds;
+    const int *counts;
+    char *string;
+
+    CHECK(Policy,
+        *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
+        "Internal error (0x%08X)",
+            *handle
+    );
+
+    // Only load when the data is there.
+    if (*handle == ADDRESS_FOLLOWING)
+    {
+        // The weapon is used where it is, without copying its fields.
+        handler = (struct WeaponHeader*)ff->ReadSharedMemory(sizeof(struct WeaponHeader), 4);
+        *handle = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, handler);
+
+        CHECK(Policy,
+            handler->szInternalName != ADDRESS_MISSING,
+            "Corrupted data. (0x%08X)",
+                handler->szInternalName
+        );
+
+        // Read the name of the weapon.
+        if (handler->szInternalName == ADDRESS_FOLLOWING)
+        {
+            name = ff->ReadSharedString();
+            handler->szInternalName = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, (void*)name);
+        }
+        else
+        {
+            name = ff->GetPointer<Policy>(handler->szInternalName);
+        }
+        VERBOSE("weapon->name = '%s'\n", name);
+
+        // Read what follows, field by field.
+        for (int c = 0; c < WEAPON_COLUMNS; c++)
+        {
+            column = &weaponColumns[c];
+            fields = (address_t*)((char*)handler + column->offset);
+
+            switch (column->kind)
+            {
+            case WEAPON_STRING:
+                for (int i = 0; i < column->count; i++)
+                {
+                    if (fields[i] == ADDRESS_FOLLOWING)
+                    {
+                        string = ff->ReadSharedString();
+                        fields[i] = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, string);
+                    }
+                }
+                break;
+
+            case WEAPON_SOUND:
+                for (int i = 0; i < column->count; i++)
+                {
+                    LoadSound<Policy>(ff, &fields[i]);
+                }
+                break;
+
+            case WEAPON_SOUNDS:
+                sounds = (address_t*)ff->ReadArray<Policy>(fields, WEAPON_SURFACE_TYPES * 4, 4);
+                if (sounds != nullptr)
+                {
+                    for (int i = 0; i < WEAPON_SURFACE_TYPES; i++)
+                    {
+                        LoadSound<Policy>(ff, &sounds[i]);
+                    }
+                }
+                break;
+
+            case WEAPON_XMODEL:
+            case WEAPON_MATERIAL:
+            case WEAPON_FX:
+                for (int i = 0; i < column->count; i++)
+                {
+                    ASSERT(fields[i] != ADDRESS_FOLLOWING, "Not yet implemented (%s of %s).", column->name, name);
+                }
+                break;
+
+            case WEAPON_KNOTS:
+                counts = (const int*)((char*)fields + WEAPON_KNOT_COUNTS);
+                for (int i = 0; i < column->count; i++)
+                {
+                    ff->ReadArray<Policy>(&fields[i], counts[i] * 2 * 4, 4);
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Reads a sound, which the weapon refers to by the name of its alias.
+ * @param sound The address of the sound, within the memory.
+ */
+template <class Policy>
+void Weapon::LoadSound(class FastFile *ff, address_t *sound)
+{
+    address_t *alias;
+    char *string;
+
+    alias = (address_t*)ff->ReadArray<Policy>(sound, 4, 4);
+    if (alias != nullptr && *alias == ADDRESS_FOLLOWING)
+    {
+        string = ff->ReadSharedString();
+        *alias = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, string);
+    }
+}
+
+void Weapon::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
+}
+
+/**
+ * Gets the name of a sound or a model. Both start with the address of their
+ * name, the headers of the other assets are not kept in the memory.
+ * @param address The address of the sound or the model.
+ * @return The interned name, or nullptr when there is none.
+ */
+template <class Policy>
+const char* Weapon::GetAssetName(class FastFile *ff, address_t address)
+{
+    const address_t *asset;
+
+    if (address == ADDRESS_MISSING)
+    {
+        return nullptr;
+    }
+
+    asset = (const address_t*)ff->GetPointer<Policy>(address);
+    if (*asset == ADDRESS_MISSING)
+    {
+        return nullptr;
+    }
+
+    return ff->Intern(ff->GetPointer<Policy>(*asset));
+}
+
+/**
+ * Stores the weapon by pointing into the memory of the fast file. Its names
+ * are looked up once and interned, so that equal names of all weapons of the
+ * file are one string.
+ * @param handle The handle to the weapon in memory.
+ */
+template <class Policy>
+void Weapon::Store(class FastFile *ff, address_t *handle)
+{
+    const struct WeaponColumn *column;
+    struct Span<address_t> sounds;
+    const address_t *fields;
+    const unsigned short *tags;
+    const int *counts;
+    int slots = 0, slot = 0, graph = 0;
+
+    CHECK(Policy,
+        *handle != ADDRESS_FOLLOWING,
+        "Corrupted data. (0x%08X)",
+            *handle
+    );
+
+    // Only load the data if there is data.
+    if (*handle != ADDRESS_MISSING)
+    {
+        header = (const struct WeaponHeader*)ff->GetPointer<Policy>(*handle);
+        name = ff->Intern(ff->GetPointer<Policy>(header->szInternalName));
+
+        for (int c = 0; c < WEAPON_COLUMNS; c++)
+        {
+            slots += GetSlots(&weaponColumns[c]);
+        }
+
+        strings = (const char**)calloc(slots, sizeof(char*));
+        if (strings == nullptr)
+        {
+            throw std::exception("Out of memory (weapon)");
+        }
+
+        for (int c = 0; c < WEAPON_COLUMNS; c++)
+        {
+            column = &weaponColumns[c];
+            fields = (const address_t*)((const char*)header + column->offset);
+
+            switch (column->kind)
+            {
+            case WEAPON_TAG:
+                tags = (const unsigned short*)fields;
+                for (int i = 0; i < column->count; i++)
+                {
+                    strings[slot++] = ff->GetTag(tags[i]);
+                }
+                break;
+
+            case WEAPON_STRING:
+                for (int i = 0; i < column->count; i++)
+                {
+                    strings[slot++] = (fields[i] != ADDRESS_MISSING) ? ff->Intern(ff->GetPointer<Policy>(fields[i])) : nullptr;
+                }
+                break;
+
+            case WEAPON_SOUND:
+            case WEAPON_XMODEL:
+                for (int i = 0; i < column->count; i++)
+                {
+                    strings[slot++] = GetAssetName<Policy>(ff, fields[i]);
+                }
+                break;
+
+            case WEAPON_MATERIAL:
+            case WEAPON_FX:
+                slot += column->count;
+                break;
+
+            case WEAPON_SOUNDS:
+                ff->GetSpan<Policy>(fields[0], WEAPON_SURFACE_TYPES, &sounds);
+                for (int i = 0; i < WEAPON_SURFACE_TYPES; i++)
+                {
+                    strings[slot++] = (i < sounds.count) ? GetAssetName<Policy>(ff, sounds.data[i]) : nullptr;
+                }
+                break;
+
+            case WEAPON_KNOTS:
+                counts = (const int*)((const char*)fields + WEAPON_KNOT_COUNTS);
+                for (int i = 0; i < column->count; i++)
+                {
+                    ff->GetSpan<Policy>(fields[i], counts[i] * 2, &knots[graph++]);
+                }
+                break;
+            }
+        }
+    }
+}
+
+void Weapon::Store(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Store<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Store<Checked>(ff, handle);
+    }
+}
+
+void Weapon::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    VERBOSE("\nWEAPON\n\t%-*s%s\n\t%-*s%i\n\t%-*s%i\n\t%-*s%i\n\t%-*s%i\n",
+        DUMP_OFFSET, "name", name,
+        DUMP_OFFSET, "weapType", header->weapType,
+        DUMP_OFFSET, "damage", header->damage,
+        DUMP_OFFSET, "clipSize", header->iClipSize,
+        DUMP_OFFSET, "maxAmmo", header->iMaxAmmo
+    );
+}
+
+const struct WeaponHeader* Weapon::GetHeader(void)
+{
+    return header;
+}
+
+/**
+ * Gets a name of the weapon, which is interned. Materials and effects have
+ * no names, as their headers are not in the memory of the fast file.
+ * @param column The number of the column, see weaponColumns.
+ * @param i The number of the name within the column.
+ */
+const char* Weapon::GetString(int column, int i)
+{
+    int slot = 0;
+
+    ASSERT(column >= 0 && column < WEAPON_COLUMNS, "Column out of range. (%i)", column);
+    ASSERT(i >= 0 && i < GetSlots(&weaponColumns[column]), "Name out of range. (%s, %i)", weaponColumns[column].name, i);
+
+    if (strings == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (int c = 0; c < column; c++)
+    {
+        slot += GetSlots(&weaponColumns[c]);
+    }
+
+    return strings[slot + i];
+}
+
+/**
+ * Writes the names of the columns, the first line of the weapon table.
+ */
+void Weapon::ExportColumns(class Writer *writer)
+{
+    for (int c = 0; c < WEAPON_COLUMNS; c++)
+    {
+        if (c > 0)
+        {
+            writer->WriteChar(',');
+        }
+        writer->WriteString(weaponColumns[c].name);
+    }
+    writer->WriteChar('\n');
+}
+
+/**
+ * Writes the names of a column as one cell, separated by spaces. The cell is
+ * quoted when a name could end it.
+ */
+static void ExportNames(class Writer *writer, const char **names, int count)
+{
+    bool quoted = false;
+
+    for (int i = 0; i < count && !quoted; i++)
+    {
+        quoted = (names[i] != nullptr && strpbrk(names[i], ",\"\r\n") != nullptr);
+    }
+
+    if (quoted)
+    {
+        writer->WriteChar('"');
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            writer->WriteChar(' ');
+        }
+
+        for (const char *c = names[i]; c != nullptr && *c != 0; c++)
+        {
+            if (*c == '"')
+            {
+                writer->WriteChar('"');
+            }
+            writer->WriteChar(*c);
+        }
+    }
+
+    if (quoted)
+    {
+        writer->WriteChar('"');
+    }
+}
+
+/**
+ * Writes the weapon as a line of the weapon table, a cell per column. Arrays
+ * are a single cell of values separated by spaces.
+ */
+void Weapon::ExportRow(class Writer *writer)
+{
+    const struct WeaponColumn *column;
+    const char *fields;
+    int slot = 0, graph = 0, slots;
+
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    for (int c = 0; c < WEAPON_COLUMNS; c++)
+    {
+        column = &weaponColumns[c];
+        fields = ((const char*)header + column->offset);
+        slots = GetSlots(column);
+
+        if (c > 0)
+        {
+            writer->WriteChar(',');
+        }
+
+        if (slots > 0)
+        {
+            ExportNames(writer, &strings[slot], slots);
+            slot += slots;
+        }
+        else if (column->kind == WEAPON_KNOTS)
+        {
+            // The graphs are separated by semicolons.
+            for (int i = 0; i < column->count; i++, graph++)
+            {
+                if (i > 0)
+                {
+                    writer->WriteChar(';');
+                }
+
+                for (int k = 0; k < knots[graph].count; k++)
+                {
+                    if (k > 0)
+                    {
+                        writer->WriteChar(' ');
+                    }
+                    writer->WriteFloat(knots[graph].data[k]);
+                }
+            }
+        }
+        else
+        {
+            for (int i = 0; i < column->count; i++)
+            {
+                if (i > 0)
+                {
+                    writer->WriteChar(' ');
+                }
+
+                if (column->kind == WEAPON_FLOAT)
+                {
+                    writer->WriteFloat(((const float*)fields)[i]);
+                }
+                else
+                {
+                    writer->WriteInt(((const int*)fields)[i]);
+                }
+            }
+        }
+    }
+    writer->WriteChar('\n');
+}
+
+/**
+ * Exports the weapon as a row of the weapon table of the fast file.
+ */
+void Weapon::Export(class FastFile *ff, class Exporter *exporter)
+{
+    class Writer *writer;
+    bool created;
+
+    UNREFERENCED_PARAMETER(ff);
+
+    writer = exporter->OpenTable(L"_weapons.csv", &created);
+    if (created)
+    {
+        ExportColumns(writer);
+    }
+    ExportRow(writer);
+}
@@ -0,0 +1,449 @@
+#ifndef WEAPON_HPP
+#define WEAPON_HPP
+
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "../writer.hpp"
+#include "../exporter.hpp"
+
+#define WEAPON_SURFACE_TYPES    29
+#define WEAPON_GRAPHS           2
+#define WEAPON_KNOT_COUNTS      0x10    /* From the knots of a graph to their count. */
+
+/* The kinds of the fields, see weaponColumns. */
+#define WEAPON_INT              0
+#define WEAPON_FLOAT            1
+#define WEAPON_TAG              2       /* Script string */
+#define WEAPON_STRING           3
+#define WEAPON_SOUND            4       /* Name of a sound alias */
+#define WEAPON_SOUNDS           5       /* Names of sound aliases, one per surface */
+#define WEAPON_XMODEL           6
+#define WEAPON_MATERIAL         7
+#define WEAPON_FX               8
+#define WEAPON_KNOTS            9
+
+/*
+ * The structure as it is within the fast file, see FORMAT DOCUMENTATION.
+ * Pointers are addresses; those of strings, sounds and assets are resolved to
+ * names by Store. Every field is four bytes or an even array of shorts, hence
+ * the structure has no padding.
+ */
+
+struct WeaponHeader
+{
+    address_t szInternalName;           // The name of the weapon
+    address_t szDisplayName;
+    address_t szOverlayName;
+    address_t gunXModel[16];
+    address_t handXModel;
+    address_t szXAnims[33];
+    address_t szModeName;
+    unsigned short hideTags[8];         // Script strings, see FastFile::GetTag
+    unsigned short notetrackSoundMapKeys[16];
+    unsigned short notetrackSoundMapValues[16];
+    int playerAnimType;
+    int weapType;
+    int weapClass;
+    int penetrateType;
+    int impactType;
+    int inventoryType;
+    int fireType;
+    int offhandClass;
+    int stance;
+    address_t viewFlashEffect;
+    address_t worldFlashEffect;
+    address_t pickupSound;
+    address_t pickupSoundPlayer;
+    address_t ammoPickupSound;
+    address_t ammoPickupSoundPlayer;
+    address_t projectileSound;
+    address_t pullbackSound;
+    address_t pullbackSoundPlayer;
+    address_t fireSound;
+    address_t fireSoundPlayer;
+    address_t fireLoopSound;
+    address_t fireLoopSoundPlayer;
+    address_t fireStopSound;
+    address_t fireStopSoundPlayer;
+    address_t fireLastSound;
+    address_t fireLastSoundPlayer;
+    address_t emptyFireSound;
+    address_t emptyFireSoundPlayer;
+    address_t meleeSwipeSound;
+    address_t meleeSwipeSoundPlayer;
+    address_t meleeHitSound;
+    address_t meleeMissSound;
+    address_t rechamberSound;
+    address_t rechamberSoundPlayer;
+    address_t reloadSound;
+    address_t reloadSoundPlayer;
+    address_t reloadEmptySound;
+    address_t reloadEmptySoundPlayer;
+    address_t reloadStartSound;
+    address_t reloadStartSoundPlayer;
+    address_t reloadEndSound;
+    address_t reloadEndSoundPlayer;
+    address_t detonateSound;
+    address_t detonateSoundPlayer;
+    address_t nightVisionWearSound;
+    address_t nightVisionWearSoundPlayer;
+    address_t nightVisionRemoveSound;
+    address_t nightVisionRemoveSoundPlayer;
+    address_t altSwitchSound;
+    address_t altSwitchSoundPlayer;
+    address_t raiseSound;
+    address_t raiseSoundPlayer;
+    address_t firstRaiseSound;
+    address_t firstRaiseSoundPlayer;
+    address_t putawaySound;
+    address_t putawaySoundPlayer;
+    address_t bounceSound;              // Of WEAPON_SURFACE_TYPES sounds
+    address_t viewShellEjectEffect;
+    address_t worldShellEjectEffect;
+    address_t viewLastShotEjectEffect;
+    address_t worldLastShotEjectEffect;
+    address_t reticleCenter;
+    address_t reticleSide;
+    int iReticleCenterSize;
+    int iReticleSideSize;
+    int iReticleMinOfs;
+    int activeReticleType;
+    float vStandMove[3];
+    float vStandRot[3];
+    float vDuckedOfs[3];
+    float vDuckedMove[3];
+    float vDuckedRot[3];
+    float vProneOfs[3];
+    float vProneMove[3];
+    float vProneRot[3];
+    float fPosMoveRate;
+    float fPosProneMoveRate;
+    float fStandMoveMinSpeed;
+    float fDuckedMoveMinSpeed;
+    float fProneMoveMinSpeed;
+    float fPosRotRate;
+    float fPosProneRotRate;
+    float fStandRotMinSpeed;
+    float fDuckedRotMinSpeed;
+    float fProneRotMinSpeed;
+    address_t worldModel[16];
+    address_t worldClipModel;
+    address_t rocketModel;
+    address_t knifeModel;
+    address_t worldKnifeModel;
+    address_t hudIcon;
+    int hudIconRatio;
+    address_t ammoCounterIcon;
+    int ammoCounterIconRatio;
+    int ammoCounterClip;
+    int iStartAmmo;
+    address_t szAmmoName;
+    int iAmmoIndex;
+    address_t szClipName;
+    int iClipIndex;
+    int iMaxAmmo;
+    int iClipSize;
+    int shotCount;
+    address_t szSharedAmmoCapName;
+    int iSharedAmmoCapIndex;
+    int iSharedAmmoCap;
+    int damage;
+    int playerDamage;
+    int iMeleeDamage;
+    int iDamageType;
+    int iFireDelay;
+    int iMeleeDelay;
+    int meleeChargeDelay;
+    int iDetonateDelay;
+    int iFireTime;
+    int iRechamberTime;
+    int iRechamberBoltTime;
+    int iHoldFireTime;
+    int iDetonateTime;
+    int iMeleeTime;
+    int meleeChargeTime;
+    int iReloadTime;
+    int reloadShowRocketTime;
+    int iReloadEmptyTime;
+    int iReloadAddTime;
+    int iReloadStartTime;
+    int iReloadStartAddTime;
+    int iReloadEndTime;
+    int iDropTime;
+    int iRaiseTime;
+    int iAltDropTime;
+    int iAltRaiseTime;
+    int quickDropTime;
+    int quickRaiseTime;
+    int iFirstRaiseTime;
+    int iEmptyRaiseTime;
+    int iEmptyDropTime;
+    int sprintInTime;
+    int sprintLoopTime;
+    int sprintOutTime;
+    int nightVisionWearTime;
+    int nightVisionWearTimeFadeOutEnd;
+    int nightVisionWearTimePowerUp;
+    int nightVisionRemoveTime;
+    int nightVisionRemoveTimePowerDown;
+    int nightVisionRemoveTimeFadeInStart;
+    int fuseTime;
+    int aiFuseTime;
+    int requireLockonToFire;
+    int noAdsWhenMagEmpty;
+    int avoidDropCleanup;
+    float autoAimRange;
+    float aimAssistRange;
+    float aimAssistRangeAds;
+    float aimPadding;
+    float enemyCrosshairRange;
+    int crosshairColorChange;
+    float moveSpeedScale;
+    float adsMoveSpeedScale;
+    float sprintDurationScale;
+    float fAdsZoomFov;
+    float fAdsZoomInFrac;
+    float fAdsZoomOutFrac;
+    address_t overlayMaterial;
+    address_t overlayMaterialLowRes;
+    int overlayReticle;
+    int overlayInterface;
+    float overlayWidth;
+    float overlayHeight;
+    float fAdsBobFactor;
+    float fAdsViewBobMult;
+    float fHipSpreadStandMin;
+    float fHipSpreadDuckedMin;
+    float fHipSpreadProneMin;
+    float hipSpreadStandMax;
+    float hipSpreadDuckedMax;
+    float hipSpreadProneMax;
+    float fHipSpreadDecayRate;
+    float fHipSpreadFireAdd;
+    float fHipSpreadTurnAdd;
+    float fHipSpreadMoveAdd;
+    float fHipSpreadDuckedDecay;
+    float fHipSpreadProneDecay;
+    float fHipReticleSidePos;
+    int iAdsTransInTime;
+    int iAdsTransOutTime;
+    float fAdsIdleAmount;
+    float fHipIdleAmount;
+    float adsIdleSpeed;
+    float hipIdleSpeed;
+    float fIdleCrouchFactor;
+    float fIdleProneFactor;
+    float fGunMaxPitch;
+    float fGunMaxYaw;
+    float swayMaxAngle;
+    float swayLerpSpeed;
+    float swayPitchScale;
+    float swayYawScale;
+    float swayHorizScale;
+    float swayVertScale;
+    float swayShellShockScale;
+    float adsSwayMaxAngle;
+    float adsSwayLerpSpeed;
+    float adsSwayPitchScale;
+    float adsSwayYawScale;
+    float adsSwayHorizScale;
+    float adsSwayVertScale;
+    int bRifleBullet;
+    int armorPiercing;
+    int bBoltAction;
+    int aimDownSight;
+    int bRechamberWhileAds;
+    float adsViewErrorMin;
+    float adsViewErrorMax;
+    int bCookOffHold;
+    int bClipOnly;
+    int adsFireOnly;
+    int cancelAutoHolsterWhenEmpty;
+    int suppressAmmoReserveDisplay;
+    int enhanced;
+    int laserSightDuringNightvision;
+    address_t killIcon;
+    int killIconRatio;
+    int flipKillIcon;
+    address_t dpadIcon;
+    int dpadIconRatio;
+    int bNoPartialReload;
+    int bSegmentedReload;
+    int iReloadAmmoAdd;
+    int iReloadStartAdd;
+    address_t szAltWeaponName;
+    int altWeaponIndex;
+    int iDropAmmoMin;
+    int iDropAmmoMax;
+    int blocksProne;
+    int silenced;
+    int iExplosionRadius;
+    int iExplosionRadiusMin;
+    int iExplosionInnerDamage;
+    int iExplosionOuterDamage;
+    float damageConeAngle;
+    int iProjectileSpeed;
+    int iProjectileSpeedUp;
+    int iProjectileSpeedForward;
+    int iProjectileActivateDist;
+    float projLifetime;
+    float timeToAccelerate;
+    float projectileCurvature;
+    address_t projectileModel;
+    int projExplosion;
+    address_t projExplosionEffect;
+    int projExplosionEffectForceNormalUp;
+    address_t projDudEffect;
+    address_t projExplosionSound;
+    address_t projDudSound;
+    int bProjImpactExplode;
+    int stickiness;
+    int hasDetonator;
+    int timedDetonation;
+    int rotate;
+    int holdButtonToThrow;
+    int freezeMovementWhenFiring;
+    float lowAmmoWarningThreshold;
+    float parallelBounce[29];
+    float perpendicularBounce[29];
+    address_t projTrailEffect;
+    float vProjectileColor[3];
+    int guidedMissileType;
+    float maxSteeringAccel;
+    int projIgnitionDelay;
+    address_t projIgnitionEffect;
+    address_t projIgnitionSound;
+    float fAdsAimPitch;
+    float fAdsCrosshairInFrac;
+    float fAdsCrosshairOutFrac;
+    int adsGunKickReducedKickBullets;
+    float adsGunKickReducedKickPercent;
+    float fAdsGunKickPitchMin;
+    float fAdsGunKickPitchMax;
+    float fAdsGunKickYawMin;
+    float fAdsGunKickYawMax;
+    float fAdsGunKickAccel;
+    float fAdsGunKickSpeedMax;
+    float fAdsGunKickSpeedDecay;
+    float fAdsGunKickStaticDecay;
+    float fAdsViewKickPitchMin;
+    float fAdsViewKickPitchMax;
+    float fAdsViewKickYawMin;
+    float fAdsViewKickYawMax;
+    float fAdsViewKickCenterSpeed;
+    float fAdsViewScatterMin;
+    float fAdsViewScatterMax;
+    float fAdsSpread;
+    int hipGunKickReducedKickBullets;
+    float hipGunKickReducedKickPercent;
+    float fHipGunKickPitchMin;
+    float fHipGunKickPitchMax;
+    float fHipGunKickYawMin;
+    float fHipGunKickYawMax;
+    float fHipGunKickAccel;
+    float fHipGunKickSpeedMax;
+    float fHipGunKickSpeedDecay;
+    float fHipGunKickStaticDecay;
+    float fHipViewKickPitchMin;
+    float fHipViewKickPitchMax;
+    float fHipViewKickYawMin;
+    float fHipViewKickYawMax;
+    float fHipViewKickCenterSpeed;
+    float fHipViewScatterMin;
+    float fHipViewScatterMax;
+    float fightDist;
+    float maxDist;
+    address_t accuracyGraphName[2];
+    address_t accuracyGraphKnots[2];    // Of float[2], counted by WEAPON_KNOT_COUNTS
+    address_t originalAccuracyGraphKnots[2];
+    int accuracyGraphKnotCount[2];
+    int originalAccuracyGraphKnotCount[2];
+    int iPositionReloadTransTime;
+    float leftArc;
+    float rightArc;
+    float topArc;
+    float bottomArc;
+    float accuracy;
+    float aiSpread;
+    float playerSpread;
+    float minTurnSpeed[2];
+    float maxTurnSpeed[2];
+    float pitchConvergenceTime;
+    float yawConvergenceTime;
+    float suppressTime;
+    float maxRange;
+    float fAnimHorRotateInc;
+    float fPlayerPositionDist;
+    address_t szUseHintString;
+    address_t dropHintString;
+    int iUseHintStringIndex;
+    int dropHintStringIndex;
+    float horizViewJitter;
+    float vertViewJitter;
+    address_t szScript;
+    float fOOPosAnimLength[2];
+    int minDamage;
+    int minPlayerDamage;
+    float fMaxDamageRange;
+    float fMinDamageRange;
+    float destabilizationRateTime;
+    float destabilizationCurvatureMax;
+    int destabilizeDistance;
+    float locationDamageMultipliers[19];
+    address_t fireRumble;
+    address_t meleeImpactRumble;
+    float adsDofStart;
+    float adsDofEnd;
+};
+
+static_assert(sizeof(struct WeaponHeader) == 0x878, "WeaponDef is 2168 bytes.");
+
+/** A field of the weapon, which is a column of the weapon table. */
+struct WeaponColumn
+{
+    const char *name;
+    unsigned short offset;
+    unsigned char count;
+    unsigned char kind;                 // WEAPON_*
+};
+
+class Weapon : public Asset
+{
+public:
+    Weapon(void);
+    ~Weapon(void);
+    void Release(void) noexcept;
+    const char* GetName(void);
+
+    void Load(class FastFile *ff, address_t *handle);
+    void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
+    void Export(class FastFile *ff, class Exporter *exporter);
+
+    const struct WeaponHeader* GetHeader(void);
+    const char* GetString(int column, int i);
+
+    // Writes the weapon table as CSV, a row per weapon after the columns
+    static void ExportColumns(class Writer *writer);
+    void ExportRow(class Writer *writer);
+
+private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
+    template <class Policy>
+    void LoadSound(class FastFile *ff, address_t *sound);
+    template <class Policy>
+    void Store(class FastFile *ff, address_t *handle);
+    template <class Policy>
+    const char* GetAssetName(class FastFile *ff, address_t address);
+
+ASSET_PROPERTIES:
+    const struct WeaponHeader *header;
+    const char *name;
+    const char **strings;               // Interned, by the slots of the columns
+    struct Span<float> knots[WEAPON_GRAPHS * 2];
+};
+
+#endif /* WEAPON_HPP */
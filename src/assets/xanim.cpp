@@ -0,0 +1,574 @@
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#   define XANIM_SSE2
+#   include <emmintrin.h>
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "xanim.hpp"
+
+#define XANIM_QUAT_SCALE        (1.0f / 32767.0f)
+
+XAnim::XAnim(void)
+{
+    header = nullptr;
+    name = nullptr;
+    numframes = 0;
+    numParts = 0;
+    partNames = nullptr;
+    notify = { nullptr, 0 };
+    dataByte = { nullptr, 0 };
+    dataShort = { nullptr, 0 };
+    dataInt = { nullptr, 0 };
+    randomDataShort = { nullptr, 0 };
+    randomDataByte = { nullptr, 0 };
+    randomDataInt = { nullptr, 0 };
+    indices = nullptr;
+    trans = nullptr;
+    quat = nullptr;
+    rotations = { 0, nullptr, nullptr };
+    translations = { 0, nullptr, nullptr };
+}
+
+XAnim::~XAnim(void)
+{
+    Release();
+}
+
+void XAnim::Release(void) noexcept
+{
+    if (partNames != nullptr)
+    {
+        free(partNames);
+        partNames = nullptr;
+    }
+
+    header = nullptr;
+    name = nullptr;
+    numframes = 0;
+    numParts = 0;
+    notify = { nullptr, 0 };
+    dataByte = { nullptr, 0 };
+    dataShort = { nullptr, 0 };
+    dataInt = { nullptr, 0 };
+    randomDataShort = { nullptr, 0 };
+    randomDataByte = { nullptr, 0 };
+    randomDataInt = { nullptr, 0 };
+    indices = nullptr;
+    trans = nullptr;
+    quat = nullptr;
+    rotations = { 0, nullptr, nullptr };
+    translations = { 0, nullptr, nullptr };
+}
+
+const char* XAnim::GetName(void)
+{
+    return name;
+}
+
+/**
+ * Gets the size of a frame index, which depends on the number of frames.
+ */
+static int GetIndexSize(int numframes)
+{
+    return (numframes < XANIM_SMALL_FRAMES) ? 1 : 2;
+}
+
+template <class Policy>
+void XAnim::Load(class FastFile *ff, address_t *handle)
+{
+    struct XAnimHeader *handler;
+    int indexSize;
+
+    CHECK(Policy,
+        *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
+        "Internal error (0x%08X)",
+            *handle
+    );
+
+    // Only load when the data is there.
+    if (*handle == ADDRESS_FOLLOWING)
+    {
+        // Read the animation values.
+        handler = (struct XAnimHeader*)ff->ReadSharedMemory(sizeof(struct XAnimHeader), 4);
+        *handle = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, handler);
+
+        CHECK(Policy,
+            handler->name != ADDRESS_MISSING,
+            "Corrupted data. (0x%08X)",
+                handler->name
+        );
+
+        // Read the name of the animation.
+        if (handler->name == ADDRESS_FOLLOWING)
+        {
+            name = ff->ReadSharedString();
+            handler->name = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, name);
+        }
+        else
+        {
+            name = ff->GetPointer<Policy>(handler->name);
+        }
+        VERBOSE("xanim->name = '%s'\n", name);
+
+        indexSize = GetIndexSize(handler->numframes);
+        ff->ReadArray<Policy>(&handler->names, handler->boneCount[XANIM_PART_TYPE_ALL] * 2, -1);
+        ff->ReadArray<Policy>(&handler->notify, handler->notifyCount * (int)sizeof(struct XAnimNotifyInfo), 4);
+
+        LoadDeltaPart<Policy>(ff, &handler->deltaPart, indexSize);
+
+        // The tracks of all parts, their layout is left to whoever reads them.
+        ff->ReadArray<Policy>(&handler->dataByte, handler->dataByteCount, -1);
+        ff->ReadArray<Policy>(&handler->dataShort, handler->dataShortCount * 2, -1);
+        ff->ReadArray<Policy>(&handler->dataInt, handler->dataIntCount * 4, 4);
+        ff->ReadArray<Policy>(&handler->randomDataShort, handler->randomDataShortCount * 2, -1);
+        ff->ReadArray<Policy>(&handler->randomDataByte, handler->randomDataByteCount, -1);
+        ff->ReadArray<Policy>(&handler->randomDataInt, handler->randomDataIntCount * 4, 4);
+        ff->ReadArray<Policy>(&handler->indices, handler->indexCount * indexSize, -1);
+    }
+}
+
+/**
+ * Reads the delta part, the motion of the whole animation. Each of its
+ * tracks is a header followed by either a single key, or the frame index
+ * of each key and then the keys.
+ * @param handle The address of the delta part, within the memory.
+ * @param indexSize The size of a frame index.
+ */
+template <class Policy>
+void XAnim::LoadDeltaPart(class FastFile *ff, address_t *handle, int indexSize)
+{
+    struct XAnimDeltaPart *part;
+    struct XAnimPartTrans *partTrans;
+    struct XAnimDeltaPartQuat *partQuat;
+    int keys;
+
+    part = (struct XAnimDeltaPart*)ff->ReadArray<Policy>(handle, sizeof(struct XAnimDeltaPart), 4);
+    if (part == nullptr)
+    {
+        return;
+    }
+
+    // The members follow the header as they are needed.
+    partTrans = (struct XAnimPartTrans*)ff->ReadArray<Policy>(&part->trans, 4, 4);
+    if (partTrans != nullptr)
+    {
+        if (partTrans->size == 0)
+        {
+            ff->ReadSharedMemory(sizeof(partTrans->u.frame0), -1);
+        }
+        else
+        {
+            keys = (partTrans->size + 1);
+            ff->ReadSharedMemory(sizeof(partTrans->u.frames), -1);
+            ff->ReadSharedMemory(keys * indexSize, -1);
+            ff->ReadArray<Policy>(&partTrans->u.frames.frames, keys * 3 * (partTrans->smallTrans ? 1 : 2), -1);
+        }
+    }
+
+    partQuat = (struct XAnimDeltaPartQuat*)ff->ReadArray<Policy>(&part->quat, 4, 4);
+    if (partQuat != nullptr)
+    {
+        if (partQuat->size == 0)
+        {
+            ff->ReadSharedMemory(sizeof(partQuat->u.frame0), -1);
+        }
+        else
+        {
+            keys = (partQuat->size + 1);
+            ff->ReadSharedMemory(sizeof(partQuat->u.frames), -1);
+            ff->ReadSharedMemory(keys * indexSize, -1);
+            ff->ReadArray<Policy>(&partQuat->u.frames, keys * 2 * 2, 4);
+        }
+    }
+}
+
+void XAnim::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
+}
+
+/**
+ * Stores the animation by pointing into the memory of the fast file. Only
+ * the names of the parts are allocated.
+ * @param handle The handle to the animation in memory.
+ */
+template <class Policy>
+void XAnim::Store(class FastFile *ff, address_t *handle)
+{
+    struct Span<unsigned short> names;
+    struct Span<unsigned char> bytes;
+    const struct XAnimDeltaPart *part;
+    int indexSize;
+
+    CHECK(Policy,
+        *handle != ADDRESS_FOLLOWING,
+        "Corrupted data. (0x%08X)",
+            *handle
+    );
+
+    // Only load the data if there is data.
+    if (*handle != ADDRESS_MISSING)
+    {
+        header = (const struct XAnimHeader*)ff->GetPointer<Policy>(*handle);
+        name = ff->GetPointer<Policy>(header->name);
+        numframes = header->numframes;
+        indexSize = GetIndexSize(numframes);
+
+        ff->GetSpan<Policy>(header->notify, header->notifyCount, &notify);
+        ff->GetSpan<Policy>(header->dataByte, header->dataByteCount, &dataByte);
+        ff->GetSpan<Policy>(header->dataShort, header->dataShortCount, &dataShort);
+        ff->GetSpan<Policy>(header->dataInt, header->dataIntCount, &dataInt);
+        ff->GetSpan<Policy>(header->randomDataShort, header->randomDataShortCount, &randomDataShort);
+        ff->GetSpan<Policy>(header->randomDataByte, header->randomDataByteCount, &randomDataByte);
+        ff->GetSpan<Policy>(header->randomDataInt, header->randomDataIntCount, &randomDataInt);
+        ff->GetSpan<Policy>(header->indices, header->indexCount * indexSize, &bytes);
+        indices = bytes.data;
+
+        // Look up the names of the parts.
+        ff->GetSpan<Policy>(header->names, header->boneCount[XANIM_PART_TYPE_ALL], &names);
+        if (names.count > 0)
+        {
+            partNames = (const char**)calloc(names.count, sizeof(char*));
+            if (partNames == nullptr)
+            {
+                throw std::exception("Out of memory (xanim)");
+            }
+
+            for (int i = 0; i < names.count; i++)
+            {
+                partNames[i] = ff->GetTag(names.data[i]);
+            }
+            numParts = names.count;
+        }
+
+        // Point the tracks of the delta part to their keys, the frame indices
+        // are within the track.
+        part = (header->deltaPart != ADDRESS_MISSING) ? (const struct XAnimDeltaPart*)ff->GetPointer<Policy>(header->deltaPart) : nullptr;
+        if (part != nullptr && part->trans != ADDRESS_MISSING)
+        {
+            trans = (const struct XAnimPartTrans*)ff->GetPointer<Policy>(part->trans);
+            if (trans->size == 0)
+            {
+                ff->GetSpan<Policy>(part->trans, 4 + (int)sizeof(trans->u.frame0), &bytes);
+                translations = { 1, trans->u.frame0, nullptr };
+            }
+            else
+            {
+                translations.keys = (trans->size + 1);
+                ff->GetSpan<Policy>(part->trans, (int)sizeof(struct XAnimPartTrans) + translations.keys * indexSize, &bytes);
+                ff->GetSpan<Policy>(trans->u.frames.frames, translations.keys * 3 * (trans->smallTrans ? 1 : 2), &bytes);
+                translations.frames = bytes.data;
+                translations.indices = (trans + 1);
+            }
+        }
+
+        if (part != nullptr && part->quat != ADDRESS_MISSING)
+        {
+            quat = (const struct XAnimDeltaPartQuat*)ff->GetPointer<Policy>(part->quat);
+            if (quat->size == 0)
+            {
+                ff->GetSpan<Policy>(part->quat, (int)sizeof(struct XAnimDeltaPartQuat), &bytes);
+                rotations = { 1, quat->u.frame0, nullptr };
+            }
+            else
+            {
+                rotations.keys = (quat->size + 1);
+                ff->GetSpan<Policy>(part->quat, (int)sizeof(struct XAnimDeltaPartQuat) + rotations.keys * indexSize, &bytes);
+                ff->GetSpan<Policy>(quat->u.frames, rotations.keys * 2 * 2, &bytes);
+                rotations.frames = bytes.data;
+                rotations.indices = (quat + 1);
+            }
+        }
+    }
+}
+
+void XAnim::Store(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Store<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Store<Checked>(ff, handle);
+    }
+}
+
+void XAnim::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    VERBOSE("\nXANIM\n\t%-*s%s\n\t%-*s%i\n\t%-*s%f\n\t%-*s%i\n\t%-*s%i\n\t%-*s%i rotations, %i translations\n",
+        DUMP_OFFSET, "name", name,
+        DUMP_OFFSET, "numframes", numframes,
+        DUMP_OFFSET, "framerate", header->framerate,
+        DUMP_OFFSET, "parts", numParts,
+        DUMP_OFFSET, "notifies", notify.count,
+        DUMP_OFFSET, "delta", rotations.keys, translations.keys
+    );
+
+    for (int i = 0; i < numParts; i++)
+    {
+        VERBOSE("\t%-*s%i %s\n", DUMP_OFFSET, "part", i, GetPartName(i));
+    }
+}
+
+int XAnim::GetFrameCount(void)
+{
+    return numframes;
+}
+
+int XAnim::GetPartCount(void)
+{
+    return numParts;
+}
+
+/**
+ * Gets the name of a part, by the order of its track type.
+ * @param i The number of the part.
+ */
+const char* XAnim::GetPartName(int i)
+{
+    ASSERT(i >= 0 && i < numParts, "Part out of range. (%i)", i);
+
+    return (partNames != nullptr) ? partNames[i] : nullptr;
+}
+
+const struct XAnimTrack* XAnim::GetRotations(void)
+{
+    return &rotations;
+}
+
+const struct XAnimTrack* XAnim::GetTranslations(void)
+{
+    return &translations;
+}
+
+/**
+ * Gets the frame of a key, a single key holds for every frame.
+ * @param track The track of the key.
+ * @param key The number of the key.
+ */
+int XAnim::GetKeyFrame(const struct XAnimTrack *track, int key)
+{
+    ASSERT(key >= 0 && key < track->keys, "Key out of range. (%i)", key);
+
+    if (track->indices == nullptr)
+    {
+        return 0;
+    }
+
+    if (GetIndexSize(numframes) == 1)
+    {
+        return ((const unsigned char*)track->indices)[key];
+    }
+
+    return ((const unsigned short*)track->indices)[key];
+}
+
+/**
+ * Decodes keys of the delta rotation, which turns about the up axis only.
+ * @param first The first key.
+ * @param count The number of keys, at most those left.
+ * @param quats The quaternions, as x, y, z and w.
+ * @return The number of keys decoded.
+ */
+int XAnim::DecodeRotations(int first, int count, float (*quats)[4])
+{
+    ASSERT(first >= 0 && count >= 0, "Keys out of range. (%i, %i)", first, count);
+
+    if (first >= rotations.keys)
+    {
+        return 0;
+    }
+
+    if (count > (rotations.keys - first))
+    {
+        count = (rotations.keys - first);
+    }
+
+    DecodeQuats((const short*)rotations.frames + (first * 2), 2, count, quats);
+    return count;
+}
+
+/**
+ * Decodes keys of the delta translation. A single key is stored as floats,
+ * others are scaled into the bounds of the track.
+ * @param first The first key.
+ * @param count The number of keys, at most those left.
+ * @param vectors The translations.
+ * @return The number of keys decoded.
+ */
+int XAnim::DecodeTranslations(int first, int count, float (*vectors)[3])
+{
+    ASSERT(first >= 0 && count >= 0, "Keys out of range. (%i, %i)", first, count);
+
+    if (first >= translations.keys || count == 0)
+    {
+        return 0;
+    }
+
+    if (count > (translations.keys - first))
+    {
+        count = (translations.keys - first);
+    }
+
+    if (translations.indices == nullptr)
+    {
+        memcpy(vectors[0], translations.frames, sizeof(float[3]));
+    }
+    else if (trans->smallTrans)
+    {
+        DecodeTrans((const unsigned char*)translations.frames + (first * 3), true, count,
+            trans->u.frames.mins, trans->u.frames.size, vectors);
+    }
+    else
+    {
+        DecodeTrans((const unsigned short*)translations.frames + (first * 3), false, count,
+            trans->u.frames.mins, trans->u.frames.size, vectors);
+    }
+
+    return count;
+}
+
+/**
+ * Expands packed quaternions, of which every component is a short scaled
+ * to [-1, 1]. Two components are the z and w of a turn about the up axis.
+ * The keys need not be of a single part, e.g. the packed data of many
+ * parts can be expanded at once.
+ * @param packed The packed keys.
+ * @param components The components per key, 2 or 4.
+ * @param count The number of keys.
+ * @param quats The quaternions, as x, y, z and w.
+ */
+void XAnim::DecodeQuats(const short *packed, int components, int count, float (*quats)[4])
+{
+    int i = 0;
+
+    ASSERT(components == 2 || components == 4, "Invalid quaternion components. (%i)", components);
+
+#ifdef XANIM_SSE2
+    const __m128 scale = _mm_set1_ps(XANIM_QUAT_SCALE);
+    const __m128 zero = _mm_setzero_ps();
+    __m128i values;
+    __m128 low, high;
+
+    // Eight shorts at a time, widened by their sign.
+    for (; (i + (8 / components)) <= count; i += (8 / components))
+    {
+        values = _mm_loadu_si128((const __m128i*)(packed + (i * components)));
+        low = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16)), scale);
+        high = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16)), scale);
+
+        if (components == 4)
+        {
+            _mm_storeu_ps(quats[i], low);
+            _mm_storeu_ps(quats[i + 1], high);
+        }
+        else
+        {
+            _mm_storeu_ps(quats[i], _mm_movelh_ps(zero, low));
+            _mm_storeu_ps(quats[i + 1], _mm_movehl_ps(low, zero));
+            _mm_storeu_ps(quats[i + 2], _mm_movelh_ps(zero, high));
+            _mm_storeu_ps(quats[i + 3], _mm_movehl_ps(high, zero));
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        const short *key = &packed[i * components];
+
+        if (components == 4)
+        {
+            quats[i][0] = ((float)key[0] * XANIM_QUAT_SCALE);
+            quats[i][1] = ((float)key[1] * XANIM_QUAT_SCALE);
+            quats[i][2] = ((float)key[2] * XANIM_QUAT_SCALE);
+            quats[i][3] = ((float)key[3] * XANIM_QUAT_SCALE);
+        }
+        else
+        {
+            quats[i][0] = 0.0f;
+            quats[i][1] = 0.0f;
+            quats[i][2] = ((float)key[0] * XANIM_QUAT_SCALE);
+            quats[i][3] = ((float)key[1] * XANIM_QUAT_SCALE);
+        }
+    }
+}
+
+/**
+ * Expands packed translations, of which every component is scaled into
+ * the bounds as mins + value * size.
+ * @param packed The packed keys, three bytes or unsigned shorts each.
+ * @param small Whether the components are bytes.
+ * @param count The number of keys.
+ * @param mins The least translation.
+ * @param size The size of a step of a component.
+ * @param vectors The translations.
+ */
+void XAnim::DecodeTrans(const void *packed, bool small, int count, const float *mins, const float *size, float (*vectors)[3])
+{
+    const unsigned char *bytes = (const unsigned char*)packed;
+    const unsigned short *shorts = (const unsigned short*)packed;
+    int i = 0;
+
+#ifdef XANIM_SSE2
+    // Four keys are twelve components, which repeat the bounds thrice.
+    const __m128 mins0 = _mm_setr_ps(mins[0], mins[1], mins[2], mins[0]);
+    const __m128 mins1 = _mm_setr_ps(mins[1], mins[2], mins[0], mins[1]);
+    const __m128 mins2 = _mm_setr_ps(mins[2], mins[0], mins[1], mins[2]);
+    const __m128 size0 = _mm_setr_ps(size[0], size[1], size[2], size[0]);
+    const __m128 size1 = _mm_setr_ps(size[1], size[2], size[0], size[1]);
+    const __m128 size2 = _mm_setr_ps(size[2], size[0], size[1], size[2]);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i low, high;
+    float *out;
+    int last;
+
+    for (; (i + 4) <= count; i += 4)
+    {
+        // Widen the components to unsigned shorts, reading no more than them.
+        if (small)
+        {
+            memcpy(&last, &bytes[(i * 3) + 8], 4);
+            low = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&bytes[i * 3]), zero);
+            high = _mm_unpacklo_epi8(_mm_cvtsi32_si128(last), zero);
+        }
+        else
+        {
+            low = _mm_loadu_si128((const __m128i*)&shorts[i * 3]);
+            high = _mm_loadl_epi64((const __m128i*)&shorts[(i * 3) + 8]);
+        }
+
+        out = vectors[i];
+        _mm_storeu_ps(out, _mm_add_ps(mins0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), size0)));
+        _mm_storeu_ps(out + 4, _mm_add_ps(mins1, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), size1)));
+        _mm_storeu_ps(out + 8, _mm_add_ps(mins2, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), size2)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            vectors[i][j] = (mins[j] + ((float)(small ? bytes[(i * 3) + j] : shorts[(i * 3) + j]) * size[j]));
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#ifndef XANIM_HPP
+#define XANIM_HPP
+
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+
+#define XANIM_PART_TYPES        10
+#define XANIM_PART_TYPE_ALL     9       /* The count of all parts. */
+#define XANIM_SMALL_FRAMES      256     /* Fewer frames are indexed by bytes. */
+
+/*
+ * The structures as they are within the fast file, see FORMAT DOCUMENTATION.
+ * Pointers are addresses, which Store translates.
+ */
+
+struct XAnimNotifyInfo
+{
+    unsigned short name;                // Script string
+    float time;
+};
+
+struct XAnimDeltaPart
+{
+    address_t trans;
+    address_t quat;
+};
+
+/** Followed by the frame indices when there is more than one key. */
+struct XAnimPartTrans
+{
+    unsigned short size;                // Keys - 1
+    unsigned char smallTrans;           // Keys of bytes instead of shorts
+    union
+    {
+        struct
+        {
+            float mins[3];
+            float size[3];
+            address_t frames;
+        } frames;
+        float frame0[3];
+    } u;
+};
+
+/** Followed by the frame indices when there is more than one key. */
+struct XAnimDeltaPartQuat
+{
+    unsigned short size;                // Keys - 1
+    union
+    {
+        address_t frames;               // Of short[2]
+        short frame0[2];
+    } u;
+};
+
+struct XAnimHeader
+{
+    address_t name;
+    unsigned short dataByteCount;
+    unsigned short dataShortCount;
+    unsigned short dataIntCount;
+    unsigned short randomDataByteCount;
+    unsigned short randomDataIntCount;
+    unsigned short numframes;
+    unsigned char bLoop;
+    unsigned char bDelta;
+    unsigned char boneCount[XANIM_PART_TYPES];
+    unsigned char notifyCount;
+    unsigned char assetType;
+    unsigned char isDefault;
+    int randomDataShortCount;
+    int indexCount;
+    float framerate;
+    float frequency;
+    address_t names;                    // Script strings, see FastFile::GetTag
+    address_t dataByte;
+    address_t dataShort;
+    address_t dataInt;
+    address_t randomDataShort;
+    address_t randomDataByte;
+    address_t randomDataInt;
+    address_t indices;                  // Bytes or shorts, see XANIM_SMALL_FRAMES
+    address_t notify;
+    address_t deltaPart;
+};
+
+static_assert(sizeof(struct XAnimHeader) == 0x58, "XAnimParts is 88 bytes.");
+static_assert(sizeof(struct XAnimPartTrans) == 0x20, "XAnimPartTrans is 32 bytes.");
+
+/**
+ * A track of the delta part. The keys are those of the fast file, a track of
+ * a single key has it inline.
+ */
+struct XAnimTrack
+{
+    int keys;
+    const void *frames;                 // Of keys entries
+    const void *indices;                // The frame of each key, when keys > 1
+};
+
+class XAnim : public Asset
+{
+public:
+    XAnim(void);
+    ~XAnim(void);
+    void Release(void) noexcept;
+    const char* GetName(void);
+
+    void Load(class FastFile *ff, address_t *handle);
+    void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
+
+    int GetFrameCount(void);
+    int GetPartCount(void);
+    const char* GetPartName(int i);
+
+    // The keys of the delta part, decoded in batches
+    const struct XAnimTrack* GetRotations(void);
+    const struct XAnimTrack* GetTranslations(void);
+    int GetKeyFrame(const struct XAnimTrack *track, int key);
+    int DecodeRotations(int first, int count, float (*quats)[4]);
+    int DecodeTranslations(int first, int count, float (*trans)[3]);
+
+    // Expands packed keys into floats, e.g. of many parts at once
+    static void DecodeQuats(const short *packed, int components, int count, float (*quats)[4]);
+    static void DecodeTrans(const void *packed, bool small, int count, const float *mins, const float *size, float (*trans)[3]);
+
+private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
+    template <class Policy>
+    void LoadDeltaPart(class FastFile *ff, address_t *handle, int indexSize);
+    template <class Policy>
+    void Store(class FastFile *ff, address_t *handle);
+
+ASSET_PROPERTIES:
+    const struct XAnimHeader *header;
+    char *name;
+    int numframes;
+    int numParts;
+    const char **partNames;
+    struct Span<struct XAnimNotifyInfo> notify;
+    struct Span<unsigned char> dataByte;
+    struct Span<short> dataShort;
+    struct Span<int> dataInt;
+    struct Span<short> randomDataShort;
+    struct Span<unsigned char> randomDataByte;
+    struct Span<int> randomDataInt;
+    const void *indices;                // Of header->indexCount entries
+    const struct XAnimPartTrans *trans;
+    const struct XAnimDeltaPartQuat *quat;
+    struct XAnimTrack rotations;
+    struct XAnimTrack translations;
+};
+
+#endif /* XANIM_HPP */
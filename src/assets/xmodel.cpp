@@ -0,0 +1,839 @@
+#include <cstdlib>
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "../writer.hpp"
+#include "../exporter.hpp"
+#include "xmodel.hpp"
+
+/** The material of each surface in exports, its values are the defaults. */
+static const char exportMaterial[] =
+    "COLOR 0.000000 0.000000 0.000000 1.000000\n"
+    "TRANSPARENCY 0.000000 0.000000 0.000000 1.000000\n"
+    "AMBIENTCOLOR 0.000000 0.000000 0.000000 1.000000\n"
+    "INCANDESCENCE 0.000000 0.000000 0.000000 1.000000\n"
+    "COEFFS 0.800000 0.000000\n"
+    "GLOW 0.000000 0\n"
+    "REFRACTIVE 6 1.000000\n"
+    "SPECULARCOLOR -1.000000 -1.000000 -1.000000 1.000000\n"
+    "REFLECTIVECOLOR -1.000000 -1.000000 -1.000000 1.000000\n"
+    "REFLECTIVE -1 -1.000000\n"
+    "BLINN -1.000000 -1.000000\n"
+    "PHONG -1.000000\n";
+
+XModel::XModel(void)
+{
+    header = nullptr;
+    name = nullptr;
+    numBones = 0;
+    boneNames = nullptr;
+    parentList = { nullptr, 0 };
+    quats = { nullptr, 0 };
+    trans = { nullptr, 0 };
+    partClassification = { nullptr, 0 };
+    baseMat = { nullptr, 0 };
+    surfaces = nullptr;
+    numsurfs = 0;
+    collSurfs = { nullptr, 0 };
+    boneInfo = { nullptr, 0 };
+    highMipBounds = { nullptr, 0 };
+    physPreset = nullptr;
+}
+
+XModel::~XModel(void)
+{
+    Release();
+}
+
+void XModel::Release(void) noexcept
+{
+    if (boneNames != nullptr)
+    {
+        free(boneNames);
+        boneNames = nullptr;
+    }
+
+    if (surfaces != nullptr)
+    {
+        free(surfaces);
+        surfaces = nullptr;
+    }
+
+    header = nullptr;
+    name = nullptr;
+    numBones = 0;
+    parentList = { nullptr, 0 };
+    quats = { nullptr, 0 };
+    trans = { nullptr, 0 };
+    partClassification = { nullptr, 0 };
+    baseMat = { nullptr, 0 };
+    numsurfs = 0;
+    collSurfs = { nullptr, 0 };
+    boneInfo = { nullptr, 0 };
+    highMipBounds = { nullptr, 0 };
+    preset.Release();
+    physPreset = nullptr;
+}
+
+const char* XModel::GetName(void)
+{
+    return name;
+}
+
+template <class Policy>
+void XModel::Load(class FastFile *ff, address_t *handle)
+{
+    struct XModelHeader *handler;
+    struct XSurface *surfs;
+    struct XModelCollSurf *coll;
+    struct PhysGeomList *physGeoms;
+    struct PhysGeomInfo *geoms;
+    address_t *materials;
+    int bones;
+
+    CHECK(Policy,
+        *handle == ADDRESS_MISSING || *handle == ADDRESS_FOLLOWING,
+        "Internal error (0x%08X)",
+            *handle
+    );
+
+    // Only load when the data is there.
+    if (*handle == ADDRESS_FOLLOWING)
+    {
+        // Read the model values.
+        handler = (struct XModelHeader*)ff->ReadSharedMemory(sizeof(struct XModelHeader), 4);
+        *handle = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, handler);
+
+        CHECK(Policy,
+            handler->name != ADDRESS_MISSING,
+            "Corrupted data. (0x%08X)",
+                handler->name
+        );
+        CHECK(Policy,
+            handler->numRootBones <= handler->numBones,
+            "Corrupted data. (%i root bones of %i)",
+                handler->numRootBones, handler->numBones
+        );
+
+        // Read the name of the model.
+        if (handler->name == ADDRESS_FOLLOWING)
+        {
+            name = ff->ReadSharedString();
+            handler->name = ff->GetAddress<Policy>(XFILE_BLOCK_VIRTUAL, name);
+        }
+        else
+        {
+            name = ff->GetPointer<Policy>(handler->name);
+        }
+        VERBOSE("xmodel->name = '%s'\n", name);
+
+        // The root bones have no parent, nor a pose relative to it.
+        bones = (handler->numBones - handler->numRootBones);
+        ff->ReadArray<Policy>(&handler->boneNames, handler->numBones * 2, -1);
+        ff->ReadArray<Policy>(&handler->parentList, bones, -1);
+        ff->ReadArray<Policy>(&handler->quats, bones * 4 * 2, -1);
+        ff->ReadArray<Policy>(&handler->trans, bones * 3 * 4, 4);
+        ff->ReadArray<Policy>(&handler->partClassification, handler->numBones, -1);
+        ff->ReadArray<Policy>(&handler->baseMat, handler->numBones * (int)sizeof(struct DObjAnimMat), 4);
+
+        // Read the surfaces, each followed by its vertices and triangles.
+        surfs = (struct XSurface*)ff->ReadArray<Policy>(&handler->surfs, handler->numsurfs * (int)sizeof(struct XSurface), 4);
+        if (surfs != nullptr)
+        {
+            for (int i = 0; i < handler->numsurfs; i++)
+            {
+                LoadSurface<Policy>(ff, &surfs[i]);
+            }
+        }
+
+        // The materials are assets of their own.
+        materials = (address_t*)ff->ReadArray<Policy>(&handler->materialHandles, handler->numsurfs * 4, 4);
+        if (materials != nullptr)
+        {
+            for (int i = 0; i < handler->numsurfs; i++)
+            {
+                ASSERT(materials[i] != ADDRESS_FOLLOWING, "Not yet implemented (material of %s).", name);
+            }
+        }
+
+        // Read the collision surfaces.
+        coll = (struct XModelCollSurf*)ff->ReadArray<Policy>(&handler->collSurfs, handler->numCollSurfs * (int)sizeof(struct XModelCollSurf), 4);
+        if (coll != nullptr)
+        {
+            for (int i = 0; i < handler->numCollSurfs; i++)
+            {
+                ff->ReadArray<Policy>(&coll[i].collTris, coll[i].numCollTris * (int)sizeof(struct XModelCollTri), 4);
+            }
+        }
+
+        ff->ReadArray<Policy>(&handler->boneInfo, handler->numBones * (int)sizeof(struct XBoneInfo), 4);
+        ff->ReadArray<Policy>(&handler->highMipBounds, handler->numsurfs * (int)sizeof(struct XModelHighMipBounds), 4);
+
+        // Read the physics preset, the address remains following.
+        if (handler->physPreset == ADDRESS_FOLLOWING)
+        {
+            address_t preset_h = ADDRESS_FOLLOWING;
+            preset.Load(ff, &preset_h);
+        }
+
+        // Read the physics geometry.
+        physGeoms = (struct PhysGeomList*)ff->ReadArray<Policy>(&handler->physGeoms, sizeof(struct PhysGeomList), 4);
+        if (physGeoms != nullptr)
+        {
+            geoms = (struct PhysGeomInfo*)ff->ReadArray<Policy>(&physGeoms->geoms, physGeoms->count * (int)sizeof(struct PhysGeomInfo), 4);
+            if (geoms != nullptr)
+            {
+                for (int i = 0; i < physGeoms->count; i++)
+                {
+                    ASSERT(geoms[i].brush == ADDRESS_MISSING, "Not yet implemented (brush of %s).", name);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Reads what follows a surface. The vertices and the triangles go to blocks
+ * of their own, which may be streamed past.
+ * @param surface The surface, within the memory.
+ */
+template <class Policy>
+void XModel::LoadSurface(class FastFile *ff, struct XSurface *surface)
+{
+    struct XRigidVertList *lists;
+    struct XSurfaceCollisionTree *tree;
+    int blend;
+
+    // Each vertex weighted by n bones takes 2n - 1 entries.
+    blend = (surface->vertInfo[0] + (surface->vertInfo[1] * 3) +
+        (surface->vertInfo[2] * 5) + (surface->vertInfo[3] * 7));
+    ff->ReadArray<Policy>(&surface->vertsBlend, blend * 2, -1);
+
+    ff->ReadArray<Policy>(&surface->verts0, surface->vertCount * (int)sizeof(struct GfxPackedVertex), 16, XFILE_BLOCK_VERTEX);
+
+    lists = (struct XRigidVertList*)ff->ReadArray<Policy>(&surface->vertList, surface->vertListCount * (int)sizeof(struct XRigidVertList), 4);
+    if (lists != nullptr)
+    {
+        for (int i = 0; i < surface->vertListCount; i++)
+        {
+            tree = (struct XSurfaceCollisionTree*)ff->ReadArray<Policy>(&lists[i].collisionTree, sizeof(struct XSurfaceCollisionTree), 4);
+            if (tree != nullptr)
+            {
+                ff->ReadArray<Policy>(&tree->nodes, tree->nodeCount * 16, 16);
+                ff->ReadArray<Policy>(&tree->leafs, tree->leafCount * 2, -1);
+            }
+        }
+    }
+
+    ff->ReadArray<Policy>(&surface->triIndices, surface->triCount * 3 * 2, 16, XFILE_BLOCK_INDEX);
+}
+
+void XModel::Load(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Load<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Load<Checked>(ff, handle);
+    }
+}
+
+/**
+ * Stores the model by pointing into the memory of the fast file. Only the
+ * names of the bones and the surfaces are allocated.
+ * @param handle The handle to the model in memory.
+ */
+template <class Policy>
+void XModel::Store(class FastFile *ff, address_t *handle)
+{
+    struct Span<unsigned short> names;
+    struct Span<struct XSurface> surfs;
+    int bones;
+
+    CHECK(Policy,
+        *handle != ADDRESS_FOLLOWING,
+        "Corrupted data. (0x%08X)",
+            *handle
+    );
+
+    // Only load the data if there is data.
+    if (*handle != ADDRESS_MISSING)
+    {
+        header = (const struct XModelHeader*)ff->GetPointer<Policy>(*handle);
+        name = ff->GetPointer<Policy>(header->name);
+        numBones = header->numBones;
+        bones = (header->numBones - header->numRootBones);
+
+        ff->GetSpan<Policy>(header->parentList, bones, &parentList);
+        ff->GetSpan<Policy>(header->quats, bones * 4, &quats);
+        ff->GetSpan<Policy>(header->trans, bones * 3, &trans);
+        ff->GetSpan<Policy>(header->partClassification, numBones, &partClassification);
+        ff->GetSpan<Policy>(header->baseMat, numBones, &baseMat);
+        ff->GetSpan<Policy>(header->collSurfs, header->numCollSurfs, &collSurfs);
+        ff->GetSpan<Policy>(header->boneInfo, numBones, &boneInfo);
+        ff->GetSpan<Policy>(header->highMipBounds, header->numsurfs, &highMipBounds);
+
+        // Look up the names of the bones.
+        ff->GetSpan<Policy>(header->boneNames, numBones, &names);
+        if (names.count > 0)
+        {
+            boneNames = (const char**)calloc(names.count, sizeof(char*));
+            if (boneNames == nullptr)
+            {
+                throw std::exception("Out of memory (xmodel)");
+            }
+
+            for (int i = 0; i < names.count; i++)
+            {
+                boneNames[i] = ff->GetTag(names.data[i]);
+            }
+        }
+
+        // Point each surface to its arrays.
+        ff->GetSpan<Policy>(header->surfs, header->numsurfs, &surfs);
+        if (surfs.count > 0)
+        {
+            surfaces = (struct XModelSurface*)calloc(surfs.count, sizeof(struct XModelSurface));
+            if (surfaces == nullptr)
+            {
+                throw std::exception("Out of memory (xmodel)");
+            }
+
+            for (int i = 0; i < surfs.count; i++)
+            {
+                const struct XSurface *surface = &surfs.data[i];
+
+                surfaces[i].surface = surface;
+                ff->GetSpan<Policy>(surface->verts0, surface->vertCount, &surfaces[i].verts);
+                ff->GetSpan<Policy>(surface->triIndices, surface->triCount * 3, &surfaces[i].triIndices);
+                ff->GetSpan<Policy>(surface->vertsBlend,
+                    (surface->vertInfo[0] + (surface->vertInfo[1] * 3) +
+                        (surface->vertInfo[2] * 5) + (surface->vertInfo[3] * 7)),
+                    &surfaces[i].vertsBlend);
+                ff->GetSpan<Policy>(surface->vertList, surface->vertListCount, &surfaces[i].vertLists);
+            }
+            numsurfs = surfs.count;
+        }
+
+        // Only a preset within the model was loaded.
+        physPreset = (header->physPreset == ADDRESS_FOLLOWING) ? &preset : nullptr;
+    }
+}
+
+void XModel::Store(class FastFile *ff, address_t *handle)
+{
+    if (ff->IsTrusted())
+    {
+        Store<Unchecked>(ff, handle);
+    }
+    else
+    {
+        Store<Checked>(ff, handle);
+    }
+}
+
+int XModel::GetSurfaceCount(void)
+{
+    return numsurfs;
+}
+
+/**
+ * Gets a surface, its vertices and triangles point into the fast file.
+ * @param i The number of the surface.
+ */
+const struct XModelSurface* XModel::GetSurface(int i)
+{
+    ASSERT(i >= 0 && i < numsurfs, "Surface out of range. (%i)", i);
+
+    return &surfaces[i];
+}
+
+int XModel::GetBoneCount(void)
+{
+    return numBones;
+}
+
+/**
+ * Gets the name of a bone, root bones come first.
+ * @param i The number of the bone.
+ */
+const char* XModel::GetBoneName(int i)
+{
+    ASSERT(i >= 0 && i < numBones, "Bone out of range. (%i)", i);
+
+    return (boneNames != nullptr) ? boneNames[i] : nullptr;
+}
+
+int XModel::GetLodCount(void)
+{
+    if (header == nullptr || header->numLods < 0)
+    {
+        return 0;
+    }
+
+    return (header->numLods < XMODEL_LODS) ? header->numLods : XMODEL_LODS;
+}
+
+/**
+ * Writes a key and its values, e.g. "OFFSET 0.000000, 1.000000, 0.000000".
+ */
+static void WriteValues(class Writer *writer, const char *key, const float *values, int count, const char *separator)
+{
+    writer->WriteString(key);
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            writer->WriteString(separator);
+        }
+        writer->WriteFloat(values[i]);
+    }
+    writer->WriteChar('\n');
+}
+
+/**
+ * Unpacks a half float, two of which make up the texture coordinates.
+ */
+static float UnpackHalf(unsigned int half)
+{
+    union
+    {
+        unsigned int bits;
+        float value;
+    } unpacked;
+    unsigned int exponent = ((half >> 10) & 0x1F);
+    unsigned int mantissa = (half & 0x3FF);
+
+    if (exponent == 0)
+    {
+        unpacked.value = ((float)mantissa / 16777216.0f);
+    }
+    else if (exponent == 0x1F)
+    {
+        unpacked.bits = (0x7F800000 | (mantissa << 13));
+    }
+    else
+    {
+        unpacked.bits = (((exponent + 112) << 23) | (mantissa << 13));
+    }
+
+    return (half & 0x8000) ? -unpacked.value : unpacked.value;
+}
+
+/**
+ * Unpacks a normal, of which the fourth byte is the scale.
+ */
+static void UnpackUnitVec(unsigned int packed, float *vector)
+{
+    float scale = (((float)((packed >> 24) & 0xFF) + 192.0f) / 32385.0f);
+
+    for (int i = 0; i < 3; i++)
+    {
+        vector[i] = (((float)((packed >> (i * 8)) & 0xFF) - 127.0f) * scale);
+    }
+}
+
+/**
+ * Writes a vertex with its position and the bones it is weighted by.
+ */
+static void ExportVertex(class Writer *writer, int index, const struct GfxPackedVertex *vertex, int count, const int *bones, const float *weights)
+{
+    writer->WriteString("VERT ");
+    writer->WriteInt(index);
+    writer->WriteChar('\n');
+    WriteValues(writer, "OFFSET ", vertex->xyz, 3, ", ");
+    writer->WriteString("BONES ");
+    writer->WriteInt(count);
+    writer->WriteChar('\n');
+
+    for (int i = 0; i < count; i++)
+    {
+        writer->WriteString("BONE ");
+        writer->WriteInt(bones[i]);
+        writer->WriteChar(' ');
+        writer->WriteFloat(weights[i]);
+        writer->WriteChar('\n');
+    }
+}
+
+/**
+ * Writes the bones and their pose. The pose is a rotation and a translation
+ * in model space, the matrix is made from the rotation.
+ */
+void XModel::ExportBones(class Writer *writer)
+{
+    float offset[3], axes[3][3];
+    int parent;
+
+    writer->WriteString("NUMBONES ");
+    writer->WriteInt(numBones);
+    writer->WriteChar('\n');
+
+    // The parents are relative, root bones have none.
+    for (int i = 0; i < numBones; i++)
+    {
+        parent = -1;
+        if (i >= header->numRootBones && (i - header->numRootBones) < parentList.count)
+        {
+            parent = (i - parentList.data[i - header->numRootBones]);
+            parent = (parent >= 0 && parent < i) ? parent : -1;
+        }
+
+        writer->WriteString("BONE ");
+        writer->WriteInt(i);
+        writer->WriteChar(' ');
+        writer->WriteInt(parent);
+        writer->WriteString(" \"");
+        writer->WriteString((GetBoneName(i) != nullptr) ? GetBoneName(i) : "");
+        writer->WriteString("\"\n");
+    }
+
+    for (int i = 0; i < numBones; i++)
+    {
+        offset[0] = offset[1] = offset[2] = 0.0f;
+        axes[0][0] = 1.0f; axes[0][1] = 0.0f; axes[0][2] = 0.0f;
+        axes[1][0] = 0.0f; axes[1][1] = 1.0f; axes[1][2] = 0.0f;
+        axes[2][0] = 0.0f; axes[2][1] = 0.0f; axes[2][2] = 1.0f;
+
+        if (i < baseMat.count)
+        {
+            const struct DObjAnimMat *mat = &baseMat.data[i];
+            float x = mat->quat[0], y = mat->quat[1], z = mat->quat[2], w = mat->quat[3];
+            float scale = mat->transWeight;
+
+            // The weight is 2 / |q|^2, computed when it is not there.
+            if (scale == 0.0f && (x * x + y * y + z * z + w * w) > 0.0f)
+            {
+                scale = (2.0f / (x * x + y * y + z * z + w * w));
+            }
+
+            axes[0][0] = 1.0f - (y * y + z * z) * scale;
+            axes[0][1] = (x * y + w * z) * scale;
+            axes[0][2] = (x * z - w * y) * scale;
+            axes[1][0] = (x * y - w * z) * scale;
+            axes[1][1] = 1.0f - (x * x + z * z) * scale;
+            axes[1][2] = (y * z + w * x) * scale;
+            axes[2][0] = (x * z + w * y) * scale;
+            axes[2][1] = (y * z - w * x) * scale;
+            axes[2][2] = 1.0f - (x * x + y * y) * scale;
+
+            offset[0] = mat->trans[0];
+            offset[1] = mat->trans[1];
+            offset[2] = mat->trans[2];
+        }
+
+        writer->WriteString("\nBONE ");
+        writer->WriteInt(i);
+        writer->WriteChar('\n');
+        WriteValues(writer, "OFFSET ", offset, 3, ", ");
+        writer->WriteString("SCALE 1.000000, 1.000000, 1.000000\n");
+        WriteValues(writer, "X ", axes[0], 3, ", ");
+        WriteValues(writer, "Y ", axes[1], 3, ", ");
+        WriteValues(writer, "Z ", axes[2], 3, ", ");
+    }
+
+    writer->WriteChar('\n');
+}
+
+/**
+ * Writes the vertices of a surface. Rigid surfaces list their vertices per
+ * bone, the others by the number of bones they are weighted by.
+ * @param base The number of the first vertex.
+ */
+void XModel::ExportVertices(class Writer *writer, const struct XModelSurface *surface, int base)
+{
+    const struct XSurface *raw = surface->surface;
+    const unsigned short *blend = surface->vertsBlend.data;
+    float weights[4];
+    int bones[4];
+    int v = 0;
+
+    for (int l = 0; l < surface->vertLists.count; l++)
+    {
+        bones[0] = (surface->vertLists.data[l].boneOffset / XMODEL_BONE_STRIDE);
+        weights[0] = 1.0f;
+
+        for (int k = 0; k < surface->vertLists.data[l].vertCount && v < raw->vertCount; k++, v++)
+        {
+            ExportVertex(writer, base + v, &surface->verts.data[v], 1, bones, weights);
+        }
+    }
+
+    // Each weighted vertex is its bone and the other bones with their weights.
+    if (surface->vertLists.count == 0 && blend != nullptr)
+    {
+        for (int n = 0; n < 4; n++)
+        {
+            for (int k = 0; k < raw->vertInfo[n] && v < raw->vertCount; k++, v++)
+            {
+                bones[0] = (blend[0] / XMODEL_BONE_STRIDE);
+                weights[0] = 1.0f;
+
+                for (int j = 1; j <= n; j++)
+                {
+                    bones[j] = (blend[(j * 2) - 1] / XMODEL_BONE_STRIDE);
+                    weights[j] = ((float)blend[j * 2] / 65536.0f);
+                    weights[0] -= weights[j];
+                }
+
+                ExportVertex(writer, base + v, &surface->verts.data[v], n + 1, bones, weights);
+                blend += ((n * 2) + 1);
+            }
+        }
+    }
+
+    // Vertices without weights belong to the first bone.
+    bones[0] = 0;
+    weights[0] = 1.0f;
+    for (; v < raw->vertCount; v++)
+    {
+        ExportVertex(writer, base + v, &surface->verts.data[v], 1, bones, weights);
+    }
+}
+
+/**
+ * Writes the corners of a triangle.
+ * @param corners The three vertices, within the surface.
+ * @param base The number of the first vertex of the surface.
+ */
+void XModel::ExportFace(class Writer *writer, const struct XModelSurface *surface, const unsigned short *corners, int base)
+{
+    const struct GfxPackedVertex *vertex;
+    float normal[3], color[4];
+
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT(corners[i] < surface->verts.count,
+            "Corrupted data. (vertex %i of %i)",
+                corners[i], surface->verts.count
+        );
+        vertex = &surface->verts.data[corners[i]];
+
+        UnpackUnitVec(vertex->normal, normal);
+        for (int c = 0; c < 4; c++)
+        {
+            color[c] = ((float)((vertex->color >> (c * 8)) & 0xFF) / 255.0f);
+        }
+
+        writer->WriteString("VERT ");
+        writer->WriteInt(base + corners[i]);
+        writer->WriteChar('\n');
+        WriteValues(writer, "NORMAL ", normal, 3, " ");
+        WriteValues(writer, "COLOR ", color, 4, " ");
+        writer->WriteString("UV 1 ");
+        writer->WriteFloat(UnpackHalf(vertex->texCoord >> 16));
+        writer->WriteChar(' ');
+        writer->WriteFloat(UnpackHalf(vertex->texCoord & 0xFFFF));
+        writer->WriteString(" \n");
+    }
+}
+
+/**
+ * Writes a LOD in the XMODEL_EXPORT format, straight from the memory of the
+ * fast file. Each surface becomes an object with a material of its own.
+ * @param writer The writer, of which the file is open.
+ * @param lod The number of the LOD.
+ */
+void XModel::ExportLod(class Writer *writer, int lod)
+{
+    const struct XModelLodInfo *info;
+    const struct XModelSurface *surface;
+    int first, count, verts = 0, faces = 0, base;
+
+    ASSERT(lod >= 0 && lod < GetLodCount(), "LOD out of range. (%i)", lod);
+
+    info = &header->lodInfo[lod];
+    first = info->surfIndex;
+    count = info->numsurfs;
+    ASSERT(first + count <= numsurfs,
+        "Corrupted data. (surfaces %i to %i of %i)",
+            first, first + count, numsurfs
+    );
+
+    for (int i = first; i < (first + count); i++)
+    {
+        ASSERT(surfaces[i].verts.count == surfaces[i].surface->vertCount &&
+            surfaces[i].triIndices.count == (surfaces[i].surface->triCount * 3),
+            "The vertices of %s were not kept.",
+                name
+        );
+
+        verts += surfaces[i].surface->vertCount;
+        faces += surfaces[i].surface->triCount;
+    }
+
+    writer->WriteString("// Exported by deff from '");
+    writer->WriteString(name);
+    writer->WriteString("', LOD ");
+    writer->WriteInt(lod);
+    writer->WriteString("\nMODEL\nVERSION 6\n\n");
+
+    ExportBones(writer);
+
+    writer->WriteString("NUMVERTS ");
+    writer->WriteInt(verts);
+    writer->WriteChar('\n');
+    base = 0;
+    for (int i = 0; i < count; i++)
+    {
+        ExportVertices(writer, &surfaces[first + i], base);
+        base += surfaces[first + i].surface->vertCount;
+    }
+
+    writer->WriteString("\nNUMFACES ");
+    writer->WriteInt(faces);
+    writer->WriteChar('\n');
+    base = 0;
+    for (int i = 0; i < count; i++)
+    {
+        surface = &surfaces[first + i];
+
+        for (int t = 0; t < surface->surface->triCount; t++)
+        {
+            writer->WriteString("TRI ");
+            writer->WriteInt(i);
+            writer->WriteChar(' ');
+            writer->WriteInt(i);
+            writer->WriteString(" 0 0\n");
+            ExportFace(writer, surface, &surface->triIndices.data[t * 3], base);
+        }
+        base += surface->surface->vertCount;
+    }
+
+    writer->WriteString("\nNUMOBJECTS ");
+    writer->WriteInt(count);
+    writer->WriteChar('\n');
+    for (int i = 0; i < count; i++)
+    {
+        writer->WriteString("OBJECT ");
+        writer->WriteInt(i);
+        writer->WriteString(" \"");
+        writer->WriteString(name);
+        writer->WriteChar('_');
+        writer->WriteInt(first + i);
+        writer->WriteString("\"\n");
+    }
+
+    // The materials are not loaded, each is named after its surface.
+    writer->WriteString("\nNUMMATERIALS ");
+    writer->WriteInt(count);
+    writer->WriteChar('\n');
+    for (int i = 0; i < count; i++)
+    {
+        writer->WriteString("MATERIAL ");
+        writer->WriteInt(i);
+        writer->WriteString(" \"mtl_");
+        writer->WriteInt(first + i);
+        writer->WriteString("\" \"Lambert\" \"mtl_");
+        writer->WriteInt(first + i);
+        writer->WriteString(".tga\"\n");
+        writer->Write(exportMaterial, sizeof(exportMaterial) - 1);
+    }
+}
+
+/**
+ * Prints the bones and the surfaces of the model.
+ */
+void XModel::Dump(class FastFile *ff)
+{
+    UNREFERENCED_PARAMETER(ff);
+
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    VERBOSE("\nXMODEL\n\t%-*s%s\n\t%-*s%i (%i root)\n\t%-*s%i\n\t%-*s%i\n\t%-*s%f\n\t%-*s%s\n",
+        DUMP_OFFSET, "name", name,
+        DUMP_OFFSET, "numBones", numBones, header->numRootBones,
+        DUMP_OFFSET, "numsurfs", numsurfs,
+        DUMP_OFFSET, "numLods", header->numLods,
+        DUMP_OFFSET, "radius", header->radius,
+        DUMP_OFFSET, "physPreset", (physPreset != nullptr) ? physPreset->GetName() : "(none)"
+    );
+
+    for (int i = 0; i < numBones; i++)
+    {
+        VERBOSE("\t%-*s%i %s\n", DUMP_OFFSET, "bone", i, GetBoneName(i));
+    }
+
+    for (int i = 0; i < numsurfs; i++)
+    {
+        VERBOSE("\t%-*s%i %i vertices, %i triangles\n", DUMP_OFFSET, "surface", i,
+            surfaces[i].surface->vertCount, surfaces[i].surface->triCount);
+    }
+}
+
+/**
+ * FORMAT DOCUMENTATION
+ * [00] int32       name_p
+ * [04] int8        numBones
+ * [05] int8        numRootBones
+ * [06] int8        numsurfs
+ * [07] int8        lodRampType
+ * [08] int32       boneNames_p             | int16 script strings, numBones
+ * [0C] int32       parentList_p            | int8, numBones - numRootBones
+ * [10] int32       quats_p                 | int16[4], numBones - numRootBones
+ * [14] int32       trans_p                 | float[3], numBones - numRootBones
+ * [18] int32       partClassification_p    | int8, numBones
+ * [1C] int32       baseMat_p               | DObjAnimMat (0x20), numBones
+ * [20] int32       surfs_p                 | XSurface (0x38), numsurfs
+ * [24] int32       materialHandles_p       | Material, numsurfs
+ * [28] lodInfo[4]                          | XModelLodInfo (0x1C)
+ * [98] int32       collSurfs_p             | XModelCollSurf (0x2C)
+ * [9C] int32       numCollSurfs
+ * [A0] int32       contents
+ * [A4] int32       boneInfo_p              | XBoneInfo (0x28), numBones
+ * [A8] float       radius
+ * [AC] float[3]    mins
+ * [B8] float[3]    maxs
+ * [C4] int16       numLods
+ * [C6] int16       collLod
+ * [C8] int32       highMipBounds_p         | float[6], numsurfs
+ * [CC] int32       memUsage
+ * [D0] int8        flags
+ * [D1] bool        bad
+ * [D4] int32       physPreset_p
+ * [D8] int32       physGeoms_p             | PhysGeomList (0x2C)
+ *
+ * XSURFACE
+ * [00] int8        tileMode
+ * [01] bool        deformed
+ * [02] int16       vertCount
+ * [04] int16       triCount
+ * [06] int8        zoneHandle
+ * [08] int16       baseTriIndex
+ * [0A] int16       baseVertIndex
+ * [0C] int32       triIndices_p            | int16[3], triCount, index block
+ * [10] int16[4]    vertInfo                | vertices per number of bones
+ * [18] int32       vertsBlend_p
+ * [1C] int32       verts0_p                | GfxPackedVertex (0x20), vertex block
+ * [20] int32       vertListCount
+ * [24] int32       vertList_p              | XRigidVertList (0x0C)
+ * [28] int32[4]    partBits
+ *
+ * Following the model, in this order: name, boneNames, parentList, quats,
+ * trans, partClassification, baseMat, surfs (each followed by vertsBlend,
+ * verts0, vertList and triIndices), materialHandles, collSurfs, boneInfo,
+ * highMipBounds, physPreset and physGeoms.
+ */
+
+/**
+ * Exports every LOD to a file of its own, named after the model.
+ */
+void XModel::Export(class FastFile *ff, class Exporter *exporter)
+{
+    wchar_t suffix[32];
+
+    UNREFERENCED_PARAMETER(ff);
+
+    for (int lod = 0; lod < GetLodCount(); lod++)
+    {
+        swprintf(suffix, 32, L"_lod%i.XMODEL_EXPORT", lod);
+        ExportLod(exporter->OpenFile(name, suffix), lod);
+        exporter->CloseFile();
+    }
+}
@@ -0,0 +1,237 @@
+#ifndef XMODEL_HPP
+#define XMODEL_HPP
+
+#include "../utility.hpp"
+#include "../stream.hpp"
+#include "../fastfile.hpp"
+#include "../asset.hpp"
+#include "../writer.hpp"
+#include "../exporter.hpp"
+#include "physpreset.hpp"
+
+#define XMODEL_LODS             4
+#define XMODEL_BONE_STRIDE      0x40    /* Of the bone offsets, in bytes per bone. */
+
+/*
+ * The structures as they are within the fast file, see FORMAT DOCUMENTATION.
+ * Pointers are addresses, which Store translates.
+ */
+
+struct GfxPackedVertex
+{
+    float xyz[3];
+    float binormalSign;
+    unsigned int color;
+    unsigned int texCoord;              // Two halfs
+    unsigned int normal;                // Packed unit vector
+    unsigned int tangent;
+};
+
+struct XSurfaceCollisionTree
+{
+    float trans[3];
+    float scale[3];
+    int nodeCount;
+    address_t nodes;                    // 16 bytes each
+    int leafCount;
+    address_t leafs;                    // unsigned short each
+};
+
+struct XRigidVertList
+{
+    unsigned short boneOffset;
+    unsigned short vertCount;
+    unsigned short triOffset;
+    unsigned short triCount;
+    address_t collisionTree;
+};
+
+struct XSurface
+{
+    unsigned char tileMode;
+    unsigned char deformed;
+    unsigned short vertCount;
+    unsigned short triCount;
+    unsigned char zoneHandle;
+    unsigned short baseTriIndex;
+    unsigned short baseVertIndex;
+    address_t triIndices;               // In the index block
+    short vertInfo[4];                  // Vertices weighted by 1, 2, 3 and 4 bones
+    address_t vertsBlend;
+    address_t verts0;                   // In the vertex block
+    int vertListCount;
+    address_t vertList;
+    int partBits[4];
+};
+
+struct XModelLodInfo
+{
+    float dist;
+    unsigned short numsurfs;
+    unsigned short surfIndex;
+    int partBits[4];
+    unsigned char lod;
+    unsigned char smcIndexPlusOne;
+    unsigned char smcAllocBits;
+    unsigned char unused;
+};
+
+struct DObjAnimMat
+{
+    float quat[4];
+    float trans[3];
+    float transWeight;
+};
+
+struct XBoneInfo
+{
+    float bounds[2][3];
+    float offset[3];
+    float radiusSquared;
+};
+
+struct XModelCollTri
+{
+    float plane[4];
+    float svec[4];
+    float tvec[4];
+};
+
+struct XModelCollSurf
+{
+    address_t collTris;
+    int numCollTris;
+    float mins[3];
+    float maxs[3];
+    int boneIdx;
+    int contents;
+    int surfFlags;
+};
+
+struct XModelHighMipBounds
+{
+    float mins[3];
+    float maxs[3];
+};
+
+struct PhysGeomInfo
+{
+    address_t brush;
+    int type;
+    float orientation[3][3];
+    float offset[3];
+    float halfLengths[3];
+};
+
+struct PhysGeomList
+{
+    int count;
+    address_t geoms;
+    float centerOfMass[3];
+    float momentsOfInertia[3];
+    float productsOfInertia[3];
+};
+
+struct XModelHeader
+{
+    address_t name;
+    unsigned char numBones;
+    unsigned char numRootBones;
+    unsigned char numsurfs;
+    unsigned char lodRampType;
+    address_t boneNames;                // Script strings, see FastFile::GetTag
+    address_t parentList;
+    address_t quats;
+    address_t trans;
+    address_t partClassification;
+    address_t baseMat;
+    address_t surfs;
+    address_t materialHandles;
+    struct XModelLodInfo lodInfo[XMODEL_LODS];
+    address_t collSurfs;
+    int numCollSurfs;
+    int contents;
+    address_t boneInfo;
+    float radius;
+    float mins[3];
+    float maxs[3];
+    short numLods;
+    short collLod;
+    address_t highMipBounds;
+    int memUsage;
+    unsigned char flags;
+    unsigned char bad;
+    address_t physPreset;
+    address_t physGeoms;
+};
+
+static_assert(sizeof(struct GfxPackedVertex) == 0x20, "GfxPackedVertex is 32 bytes.");
+static_assert(sizeof(struct XSurface) == 0x38, "XSurface is 56 bytes.");
+static_assert(sizeof(struct XModelHeader) == 0xDC, "XModel is 220 bytes.");
+
+/**
+ * A surface of the model. The vertices and triangles are those of the fast
+ * file, they are empty when their blocks were streamed past.
+ */
+struct XModelSurface
+{
+    const struct XSurface *surface;
+    struct Span<struct GfxPackedVertex> verts;
+    struct Span<unsigned short> triIndices;     // Three per triangle
+    struct Span<unsigned short> vertsBlend;
+    struct Span<struct XRigidVertList> vertLists;
+};
+
+class XModel : public Asset
+{
+public:
+    XModel(void);
+    ~XModel(void);
+    void Release(void) noexcept;
+    const char* GetName(void);
+
+    void Load(class FastFile *ff, address_t *handle);
+    void Store(class FastFile *ff, address_t *handle);
+    void Dump(class FastFile *ff);
+    void Export(class FastFile *ff, class Exporter *exporter);
+
+    int GetSurfaceCount(void);
+    const struct XModelSurface* GetSurface(int i);
+    int GetBoneCount(void);
+    const char* GetBoneName(int i);
+    int GetLodCount(void);
+
+    // Writes a LOD in the XMODEL_EXPORT format, see data/raw
+    void ExportLod(class Writer *writer, int lod);
+
+private:
+    template <class Policy>
+    void Load(class FastFile *ff, address_t *handle);
+    template <class Policy>
+    void LoadSurface(class FastFile *ff, struct XSurface *surface);
+    template <class Policy>
+    void Store(class FastFile *ff, address_t *handle);
+    void ExportBones(class Writer *writer);
+    void ExportVertices(class Writer *writer, const struct XModelSurface *surface, int base);
+    void ExportFace(class Writer *writer, const struct XModelSurface *surface, const unsigned short *corners, int base);
+
+ASSET_PROPERTIES:
+    const struct XModelHeader *header;
+    char *name;
+    int numBones;
+    const char **boneNames;
+    struct Span<unsigned char> parentList;
+    struct Span<short> quats;                   // Four per bone
+    struct Span<float> trans;                   // Three per bone
+    struct Span<unsigned char> partClassification;
+    struct Span<struct DObjAnimMat> baseMat;
+    struct XModelSurface *surfaces;
+    int numsurfs;
+    struct Span<struct XModelCollSurf> collSurfs;
+    struct Span<struct XBoneInfo> boneInfo;
+    struct Span<struct XModelHighMipBounds> highMipBounds;
+    class Physpreset preset;                    // When it is within the model
+    class Physpreset *physPreset;
+};
+
+#endif /* XMODEL_HPP */
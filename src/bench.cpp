@@ -0,0 +1,744 @@
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "utility.hpp"
+#include "version.h"
+#include "stream.hpp"
+#include "zstream.hpp"
+#include "pipestream.hpp"
+#include "parstream.hpp"
+#include "decompressor.hpp"
+#include "mapfile.hpp"
+#include "arena.hpp"
+#include "fastfile.hpp"
+#include "writer.hpp"
+#include "assets/xmodel.hpp"
+#include <Psapi.h>
+
+#define BENCH_RUNS          3
+#define BENCH_CHUNK         0x10000
+#define BENCH_PREFIX        12          /* Bytes before the ZLib stream, see FastFile. */
+
+#define STREAM_PIPELINED    (DECOMPRESSOR_COUNT + 0)
+#define STREAM_PARALLEL     (DECOMPRESSOR_COUNT + 1)
+#define STREAM_COUNT        (DECOMPRESSOR_COUNT + 2)
+
+#define STRING_MAX          1024        /* Longer runs are not taken for strings. */
+
+#define ARENA_MODES         3           /* calloc, reserved and large pages. */
+
+#define THROW_COUNT         10000       /* Exceptions thrown per run. */
+
+#define FLOAT_COUNT         1000000     /* Floats formatted per run. */
+
+struct Benchmark
+{
+    const wchar_t *name;
+    const char *usage;
+    int (*run)(int argc, wchar_t **argv);
+};
+
+static char chunk[BENCH_CHUNK];
+
+/**
+ * Serves a block of memory in BUFFER_SIZE parts, like the ZLib streams do,
+ * without the cost of inflating.
+ */
+class MemoryStream : public Stream
+{
+public:
+    MemoryStream(const char *data, size_t size);
+
+    void Rewind(void);
+    int ReadStringBytewise(char *dest, int max);
+
+protected:
+    int Refill(void);
+
+private:
+    const char *data;
+    size_t size;
+    size_t offset;
+};
+
+MemoryStream::MemoryStream(const char *data, size_t size) :
+    Stream(nullptr)
+{
+    this->data = data;
+    this->size = size;
+    Rewind();
+}
+
+void MemoryStream::Rewind(void)
+{
+    offset = 0;
+    absPosition = 0;
+    relPosition = 0;
+    available = 0;
+}
+
+int MemoryStream::Refill(void)
+{
+    if (offset >= size)
+    {
+        return -1;
+    }
+
+    buffer = (char*)(data + offset);
+    available = (int)(((size - offset) < BUFFER_SIZE) ? (size - offset) : BUFFER_SIZE);
+    relPosition = 0;
+    offset += available;
+
+    return 0;
+}
+
+/**
+ * Stream::ReadString as it was; byte by byte, for comparison.
+ */
+int MemoryStream::ReadStringBytewise(char *dest, int max)
+{
+    int index;
+
+    for (index = 0; (max == -1 || index < max); index++)
+    {
+        if (available <= 0)
+        {
+            if (Refill())
+            {
+                throw std::exception("Could not refill STRING buffer.\n");
+            }
+        }
+
+        dest[index] = buffer[relPosition];
+
+        absPosition++;
+        relPosition++;
+        available--;
+
+        if (dest[index] == 0)
+        {
+            return (index + 1);
+        }
+    }
+
+    if (max != -1 && index == max)
+    {
+        dest[max-1] = 0;
+        throw std::exception("String buffer too small.\n");
+    }
+
+    return -1;
+}
+
+
+/**
+ * Gets the time in seconds, from an arbitrary point.
+ */
+static double Now(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Prints a result line.
+ * @param name The name of what was measured.
+ * @param bytes The number of bytes processed per run.
+ * @param seconds The time of the fastest run.
+ */
+static void Report(const char *name, long long bytes, double seconds)
+{
+    fprintf(stdout, "    %-12s %10.1f MiB/s %14lld bytes %9.3f s\n",
+        name, (seconds > 0.0) ? ((double)bytes / seconds / 1048576.0) : 0.0, bytes, seconds);
+}
+
+/**
+ * Creates a stream over the ZLib stream of a fast file.
+ * @param type A DECOMPRESSOR_* type or STREAM_* type.
+ */
+static Stream* CreateStream(int type, const char *input, size_t size)
+{
+    switch (type)
+    {
+        case STREAM_PIPELINED:  return new PipelinedZLibStream(input, size);
+        case STREAM_PARALLEL:   return new ParallelZLibStream(input, size);
+    }
+
+    return new ZLibStream(input, size, type);
+}
+
+/**
+ * Gets the name of a stream type.
+ * @param type A DECOMPRESSOR_* type or STREAM_* type.
+ */
+static const char* GetStreamName(int type)
+{
+    Decompressor *decompressor;
+    const char *name;
+
+    switch (type)
+    {
+        case STREAM_PIPELINED:  return "pipelined";
+        case STREAM_PARALLEL:   return "parallel";
+    }
+
+    decompressor = Decompressor::Create(type);
+    name = decompressor->GetName();
+    delete decompressor;
+
+    return name;
+}
+
+/**
+ * Reads a stream to its end, the way the asset loaders would in bulk.
+ * @return The number of bytes read.
+ */
+static long long Drain(Stream *stream)
+{
+    // Streams throw once there is nothing left to refill.
+    try
+    {
+        for (;;)
+        {
+            stream->ReadMemory(chunk, BENCH_CHUNK);
+        }
+    }
+    catch (const std::exception &)
+    {
+        // The end, or corrupted data, which shows as a different size.
+    }
+
+    return stream->GetPosition();
+}
+
+/**
+ * Inflates the ZLib stream of a fast file into memory.
+ */
+static void InflateAll(const char *input, size_t size, std::vector<char> *output)
+{
+    ZLibStream stream(input, size);
+
+    output->clear();
+    try
+    {
+        for (;;)
+        {
+            stream.ReadMemory(chunk, BENCH_CHUNK);
+            output->insert(output->end(), chunk, chunk + BENCH_CHUNK);
+        }
+    }
+    catch (const std::exception &)
+    {
+        // Whatever was read last is left in the chunk.
+        output->insert(output->end(), chunk, chunk + (stream.GetPosition() - (long long)output->size()));
+    }
+}
+
+/**
+ * Inflates every fast file with every backend and stream.
+ */
+static int BenchInflate(int argc, wchar_t **argv)
+{
+    for (int i = 0; i < argc; i++)
+    {
+        MappedFileSource source(argv[i]);
+        const char *input = source.GetData() + BENCH_PREFIX;
+        size_t size = source.GetSize() - BENCH_PREFIX;
+
+        if (source.GetSize() <= BENCH_PREFIX)
+        {
+            fprintf(stderr, "Not a fast file '%ls'.\n", argv[i]);
+            continue;
+        }
+
+        fprintf(stdout, "%ls (%llu bytes)\n", argv[i], (unsigned long long)source.GetSize());
+
+        for (int type = 0; type < STREAM_COUNT; type++)
+        {
+            long long bytes = 0;
+            double best = 0.0;
+
+            for (int run = 0; run < BENCH_RUNS; run++)
+            {
+                double start = Now();
+                Stream *stream = CreateStream(type, input, size);
+
+                bytes = Drain(stream);
+                delete stream;
+
+                if (run == 0 || (Now() - start) < best)
+                {
+                    best = (Now() - start);
+                }
+            }
+
+            Report(GetStreamName(type), bytes, best);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Reads the strings of every fast file, byte by byte and by scanning. The
+ * strings are the runs of printable characters in the inflated data, which
+ * are mostly names, tags and string table cells.
+ */
+static int BenchStrings(int argc, wchar_t **argv)
+{
+    std::vector<char> inflated, strings;
+    static char dest[STRING_MAX + 1];
+
+    for (int i = 0; i < argc; i++)
+    {
+        MappedFileSource source(argv[i]);
+        long long count = 0;
+        double best[2] = { 0.0, 0.0 };
+
+        if (source.GetSize() <= BENCH_PREFIX)
+        {
+            fprintf(stderr, "Not a fast file '%ls'.\n", argv[i]);
+            continue;
+        }
+
+        InflateAll(source.GetData() + BENCH_PREFIX, source.GetSize() - BENCH_PREFIX, &inflated);
+
+        // Collect the strings, with their terminators.
+        strings.clear();
+        for (size_t start = 0, end = 0; end < inflated.size(); end++)
+        {
+            unsigned char c = (unsigned char)inflated[end];
+
+            if (c == 0)
+            {
+                if (end > start && (end - start) <= STRING_MAX)
+                {
+                    strings.insert(strings.end(), inflated.begin() + start, inflated.begin() + end + 1);
+                    count++;
+                }
+                start = end + 1;
+            }
+            else if (c < 0x20 && c != '\t' && c != '\n' && c != '\r')
+            {
+                start = end + 1;
+            }
+            else if (c >= 0x7F)
+            {
+                start = end + 1;
+            }
+        }
+
+        fprintf(stdout, "%ls (%lld strings, %.1f bytes on average)\n",
+            argv[i], count, (count > 0) ? ((double)strings.size() / (double)count) : 0.0);
+
+        MemoryStream stream(strings.data(), strings.size());
+        for (int run = 0; run < BENCH_RUNS; run++)
+        {
+            for (int method = 0; method < 2; method++)
+            {
+                double start = Now();
+
+                stream.Rewind();
+                for (long long n = 0; n < count; n++)
+                {
+                    if (method == 0)
+                    {
+                        stream.ReadStringBytewise(dest, sizeof(dest));
+                    }
+                    else
+                    {
+                        stream.ReadString(dest, sizeof(dest));
+                    }
+                }
+
+                if (run == 0 || (Now() - start) < best[method])
+                {
+                    best[method] = (Now() - start);
+                }
+            }
+        }
+
+        Report("bytewise", (long long)strings.size(), best[0]);
+        Report("memchr", (long long)strings.size(), best[1]);
+    }
+
+    return 0;
+}
+
+/**
+ * Gets the working set of the process, in bytes.
+ */
+static long long GetWorkingSet(void)
+{
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+
+    return (long long)counters.WorkingSetSize;
+}
+
+/**
+ * Compares the arena of calloc with the reserved one and with large pages.
+ * The startup is the time until the first byte can be written, the fill
+ * writes the data size in chunks like the loaders do, and the load is a
+ * whole FastFile::Load.
+ */
+static int BenchArena(int argc, wchar_t **argv)
+{
+    static const char *names[ARENA_MODES] = { "calloc", "reserved", "large" };
+    static const int arenaFlags[ARENA_MODES] = { ARENA_CALLOC, ARENA_DEFAULT, ARENA_LARGE_PAGES };
+    static const int loadFlags[ARENA_MODES] = { LOAD_CALLOC, LOAD_DEFAULT, LOAD_LARGE_PAGES };
+
+    for (int i = 0; i < argc; i++)
+    {
+        size_t size;
+
+        {
+            FastFile probe(argv[i]);
+            size = (size_t)probe.ProbeDataSize();
+        }
+
+        fprintf(stdout, "%ls (%llu bytes of data)\n", argv[i], (unsigned long long)size);
+        fprintf(stdout, "    %-12s %12s %12s %12s %14s %14s\n",
+            "", "startup", "fill", "load", "after startup", "after fill");
+
+        for (int mode = 0; mode < ARENA_MODES; mode++)
+        {
+            double best[3] = { 0.0, 0.0, 0.0 };
+            long long base = 0, created = 0, filled = 0;
+            bool large = false;
+
+            for (int run = 0; run < BENCH_RUNS; run++)
+            {
+                Arena arena;
+                double start;
+
+                base = GetWorkingSet();
+                start = Now();
+                arena.Create(size, arenaFlags[mode]);
+                arena.Commit((size < BENCH_CHUNK) ? size : BENCH_CHUNK);
+                if (run == 0 || (Now() - start) < best[0])
+                {
+                    best[0] = (Now() - start);
+                }
+                created = GetWorkingSet() - base;
+                large = arena.IsLarge();
+
+                start = Now();
+                for (size_t offset = 0; offset < size; offset += BENCH_CHUNK)
+                {
+                    size_t length = ((size - offset) < BENCH_CHUNK) ? (size - offset) : BENCH_CHUNK;
+
+                    arena.Commit(offset + length);
+                    memcpy(arena.GetData() + offset, chunk, length);
+                }
+                if (run == 0 || (Now() - start) < best[1])
+                {
+                    best[1] = (Now() - start);
+                }
+                filled = GetWorkingSet() - base;
+
+                arena.Release();
+
+                FastFile ff(argv[i]);
+                start = Now();
+                ff.Load(loadFlags[mode]);
+                if (run == 0 || (Now() - start) < best[2])
+                {
+                    best[2] = (Now() - start);
+                }
+            }
+
+            fprintf(stdout, "    %-12s %10.3f ms %10.3f ms %10.3f ms %10.1f MiB %10.1f MiB%s\n",
+                names[mode], best[0] * 1000.0, best[1] * 1000.0, best[2] * 1000.0,
+                (double)created / 1048576.0, (double)filled / 1048576.0,
+                (mode == 2 && !large) ? " (normal pages, no privilege)" : "");
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Throws from a few calls deep, like the loaders do.
+ */
+static void Throw(int depth)
+{
+    if (depth > 0)
+    {
+        Throw(depth - 1);
+    }
+
+    throw Exception("Encountered unsupported asset type. (%i)", depth);
+}
+
+/**
+ * Measures the cost of the error path. First exceptions alone, caught with and
+ * without printing the stack trace, then batch loads of the given fast files,
+ * of which the corrupted and unsupported ones throw.
+ */
+static int BenchThrows(int argc, wchar_t **argv)
+{
+    double best[2] = { 0.0, 0.0 };
+    long long length = 0;
+
+    fprintf(stdout, "exceptions (%i per run)\n", THROW_COUNT);
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        for (int method = 0; method < 2; method++)
+        {
+            double start = Now();
+
+            for (int n = 0; n < THROW_COUNT; n++)
+            {
+                try
+                {
+                    Throw(3);
+                }
+                catch (const Exception &ex)
+                {
+                    if (method == 1)
+                    {
+                        length += ex.stackTrace().argc;
+                    }
+                }
+            }
+
+            if (run == 0 || (Now() - start) < best[method])
+            {
+                best[method] = (Now() - start);
+            }
+        }
+    }
+
+    fprintf(stdout, "    %-12s %10.3f us per throw\n", "caught", best[0] * 1000000.0 / THROW_COUNT);
+    fprintf(stdout, "    %-12s %10.3f us per throw (%lld frames)\n", "printed", best[1] * 1000000.0 / THROW_COUNT, length);
+
+    fprintf(stdout, "batch (%i files)\n", argc);
+    for (int method = 0; method < 2; method++)
+    {
+        double start = Now();
+        int failed = 0;
+
+        for (int i = 0; i < argc; i++)
+        {
+            try
+            {
+                FastFile ff(argv[i]);
+                ff.Load();
+            }
+            catch (const Exception &ex)
+            {
+                if (method == 1)
+                {
+                    length += ex.stackTrace().argc;
+                }
+                failed++;
+            }
+            catch (const std::exception &)
+            {
+                failed++;
+            }
+        }
+
+        fprintf(stdout, "    %-12s %10.3f s, %i of %i failed\n",
+            (method == 0) ? "caught" : "printed", Now() - start, failed, argc);
+    }
+
+    return 0;
+}
+
+/**
+ * Formats floats with fprintf and with the Writer, then exports the models
+ * of the given fast files, every LOD to a file of its own.
+ * @param argv The directory to write to, followed by the files.
+ */
+static int BenchExport(int argc, wchar_t **argv)
+{
+    double best[2] = { 0.0, 0.0 };
+    wchar_t path[MAX_PATH];
+    const wchar_t *directory = argv[0];
+
+    if (wcscpy_s(path, MAX_PATH, directory) || wcscat_s(path, MAX_PATH, L"\\floats.txt"))
+    {
+        throw Exception("Path too long for '%ls'.", directory);
+    }
+
+    fprintf(stdout, "floats (%i per run)\n", FLOAT_COUNT);
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        for (int method = 0; method < 2; method++)
+        {
+            double start = Now();
+
+            if (method == 0)
+            {
+                std::FILE *file;
+
+                if (_wfopen_s(&file, path, L"wb") != 0)
+                {
+                    throw Exception("Could not create file at path '%ls'.", path);
+                }
+                for (int n = 0; n < FLOAT_COUNT; n++)
+                {
+                    fprintf(file, "%f\n", (float)(n - (FLOAT_COUNT / 2)) / 1024.0f);
+                }
+                fclose(file);
+            }
+            else
+            {
+                Writer writer;
+
+                writer.Open(path);
+                for (int n = 0; n < FLOAT_COUNT; n++)
+                {
+                    writer.WriteFloat((float)(n - (FLOAT_COUNT / 2)) / 1024.0f);
+                    writer.WriteChar('\n');
+                }
+                writer.Close();
+            }
+
+            if (run == 0 || (Now() - start) < best[method])
+            {
+                best[method] = (Now() - start);
+            }
+        }
+    }
+
+    fprintf(stdout, "    %-12s %10.3f ns per float\n", "fprintf", best[0] * 1000000000.0 / FLOAT_COUNT);
+    fprintf(stdout, "    %-12s %10.3f ns per float\n", "writer", best[1] * 1000000000.0 / FLOAT_COUNT);
+
+    fprintf(stdout, "models (%i files)\n", argc - 1);
+    for (int i = 1; i < argc; i++)
+    {
+        FastFile ff(argv[i]);
+        Writer writer;
+        XModel *models;
+        int count, files = 0;
+        double start;
+
+        ff.Load();
+        models = ff.GetAssets<XModel>(ASSET_TYPE_XMODEL, &count);
+
+        start = Now();
+        for (int m = 0; m < count; m++)
+        {
+            for (int lod = 0; lod < models[m].GetLodCount(); lod++)
+            {
+                swprintf(path, MAX_PATH, L"%ls\\export_%i.XMODEL_EXPORT", directory, files++);
+                writer.Open(path);
+                models[m].ExportLod(&writer, lod);
+                writer.Close();
+            }
+        }
+
+        fprintf(stdout, "    %-40ls %6i models %8i files %9.3f s\n", argv[i], count, files, Now() - start);
+    }
+
+    return 0;
+}
+
+/**
+ * Loads the given fast files while building their index, then extracts every
+ * asset through the index, each from the closest checkpoint.
+ */
+static int BenchExtract(int argc, wchar_t **argv)
+{
+    for (int i = 0; i < argc; i++)
+    {
+        std::vector<std::string> names;
+        long long bytes = 0;
+        double start, indexed;
+        int missing = 0;
+
+        // Building the index writes it next to the file.
+        {
+            FastFile ff(argv[i]);
+
+            start = Now();
+            ff.Load(LOAD_INDEX);
+            indexed = (Now() - start);
+
+            for (int n = 0; n < ff.GetAssetCount(); n++)
+            {
+                const char *name = ff.GetAsset(n)->GetName();
+                names.push_back((name != nullptr) ? name : "");
+            }
+        }
+
+        // A new instance reads the index from the file.
+        FastFile ff(argv[i]);
+
+        start = Now();
+        for (const std::string &name : names)
+        {
+            Buffer_t buffer;
+
+            if (ff.ExtractAsset(name.c_str(), &buffer))
+            {
+                bytes += buffer.size;
+                free(buffer.data);
+            }
+            else
+            {
+                missing++;
+            }
+        }
+
+        fprintf(stdout, "    %-40ls indexed %9.3f s, %6i assets extracted %9.3f s (%lld bytes, %i missing)\n",
+            argv[i], indexed, (int)names.size() - missing, Now() - start, bytes, missing);
+    }
+
+    return 0;
+}
+
+static const struct Benchmark benchmarks[] =
+{
+    { L"inflate", "inflate < files >     Inflates with every backend and stream.", BenchInflate },
+    { L"strings", "strings < files >     Reads the strings of the zones, byte by byte and scanning.", BenchStrings },
+    { L"arena", "arena < files >       Allocates the data with calloc, reserved and in large pages.", BenchArena },
+    { L"throws", "throws < files >      Throws exceptions, and loads the zones of which some fail.", BenchThrows },
+    { L"export", "export < dir > < files > Formats floats, and exports the models of the zones.", BenchExport },
+    { L"extract", "extract < files >     Indexes the zones, then extracts each asset through the index.", BenchExtract },
+};
+
+
+int wmain(int argc, wchar_t **argv)
+{
+    std::fprintf(stdout, "DEFF: %s\nZLIB: %s\n", DEFF_VERSION_LONG, zlibVersion());
+
+    for (size_t i = 0; argc >= 3 && i < (sizeof(benchmarks) / sizeof(benchmarks[0])); i++)
+    {
+        if (wcscmp(argv[1], benchmarks[i].name) == 0)
+        {
+            try
+            {
+                return benchmarks[i].run(argc - 2, argv + 2);
+            }
+            catch (const Exception &ex)
+            {
+                fprintf(stderr, "\nEXCEPTION\n\t%s\n", ex.what());
+            }
+            catch (const std::exception &ex)
+            {
+                fprintf(stderr, "\nEXCEPTION\n\t%s\n", ex.what());
+            }
+            return 1;
+        }
+    }
+
+    fputs("USAGE: bench.exe < benchmark > < arguments >\n", stdout);
+    for (size_t i = 0; i < (sizeof(benchmarks) / sizeof(benchmarks[0])); i++)
+    {
+        fprintf(stdout, "    %s\n", benchmarks[i].usage);
+    }
+
+    return 0;
+}
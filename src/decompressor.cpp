@@ -0,0 +1,366 @@
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <exception>
+#include <zlib.h>
+#include "inflater.hpp"
+#include "zindex.hpp"
+#include "decompressor.hpp"
+
+/**
+ * Checks the ZLib header; deflate, no preset dictionary.
+ */
+static bool CheckHeader(const uint8_t *input, size_t size)
+{
+    return (size >= 6 && (input[0] & 0x0F) == 8 && (input[1] & 0x20) == 0 &&
+        ((input[0] << 8) | input[1]) % 31 == 0);
+}
+
+/**
+ * Checks the Adler-32 checksum following the final block.
+ * @param input The deflated data, starting at the ZLib header.
+ * @param size The number of bytes of deflated data.
+ * @param bit The bit past the final block, counted from the first block.
+ * @param adler The checksum of the output.
+ */
+static bool CheckTrailer(const uint8_t *input, size_t size, size_t bit, unsigned long adler)
+{
+    size_t offset = 2 + ((bit + 7) >> 3);
+
+    if (offset + 4 > size)
+    {
+        return false;
+    }
+
+    return (adler == (((unsigned long)input[offset] << 24) | ((unsigned long)input[offset + 1] << 16) |
+        ((unsigned long)input[offset + 2] << 8) | (unsigned long)input[offset + 3]));
+}
+
+Decompressor::~Decompressor(void)
+{
+    // Nothing to release.
+}
+
+/**
+ * Creates a backend.
+ * @param type The DECOMPRESSOR_* type.
+ */
+Decompressor* Decompressor::Create(int type)
+{
+    switch (type)
+    {
+        case DECOMPRESSOR_ZLIB:     return new ZLibDecompressor();
+        case DECOMPRESSOR_INFLATER: return new InflaterDecompressor();
+        case DECOMPRESSOR_ONESHOT:  return new OneShotDecompressor();
+    }
+
+    throw std::exception("Unknown decompressor.\n");
+}
+
+/**
+ * Records checkpoints into the index while inflating. Must be set before the
+ * first byte is decompressed.
+ * @param index The index to fill, or nullptr to stop indexing.
+ * @return true if the backend can index; otherwise, false.
+ */
+bool Decompressor::SetIndex(ZIndex *index)
+{
+    return (index == nullptr);
+}
+
+ZLibDecompressor::ZLibDecompressor(void)
+{
+    index = nullptr;
+
+    std::memset(&zStruct, 0, sizeof(z_stream));
+    zStruct.zalloc = Z_NULL;
+    zStruct.zfree = Z_NULL;
+    zStruct.opaque = Z_NULL;
+    zStruct.avail_in = 0;
+    zStruct.next_in = Z_NULL;
+
+    if (Z_OK != inflateInit(&zStruct))
+    {
+        throw std::exception("Failed to initialize ZLib.\n");
+    }
+}
+
+ZLibDecompressor::~ZLibDecompressor(void)
+{
+    inflateEnd(&zStruct);
+}
+
+const char* ZLibDecompressor::GetName(void)
+{
+    return "zlib";
+}
+
+/**
+ * Hands the next part of input to ZLib, once the last part has been used.
+ */
+void ZLibDecompressor::SetInput(const void *input, size_t size)
+{
+    if (size > UINT_MAX)
+    {
+        throw std::exception("Input too large for ZLib.\n");
+    }
+
+    zStruct.avail_in = (uInt)size;
+    zStruct.next_in = (Bytef*)input;
+}
+
+bool ZLibDecompressor::SetIndex(ZIndex *index)
+{
+    this->index = index;
+    return true;
+}
+
+/**
+ * Inflates as much as possible into the current output. When indexing,
+ * inflate stops at every block boundary to give the index a chance to
+ * record a checkpoint there.
+ */
+int ZLibDecompressor::Inflate(void)
+{
+    int result;
+
+    if (index == nullptr)
+    {
+        return inflate(&zStruct, Z_NO_FLUSH);
+    }
+
+    do
+    {
+        result = inflate(&zStruct, Z_BLOCK);
+        if (result != Z_OK)
+        {
+            break;
+        }
+
+        index->AddCheckpoint(&zStruct);
+    }
+    while (zStruct.avail_out > 0 && zStruct.avail_in > 0);
+
+    return result;
+}
+
+int ZLibDecompressor::Decompress(void *dest, int size, int *written)
+{
+    int result;
+
+    zStruct.avail_out = (uInt)size;
+    zStruct.next_out = (Bytef*)dest;
+
+    result = Inflate();
+    *written = (size - (int)zStruct.avail_out);
+
+    switch (result)
+    {
+        /* Progress */
+        case Z_OK:
+            return (zStruct.avail_in == 0) ? DECOMPRESS_INPUT : DECOMPRESS_OK;
+
+        /* No more data */
+        case Z_STREAM_END:
+            return DECOMPRESS_END;
+
+        /* No progress possible without input */
+        case Z_BUF_ERROR:
+            return DECOMPRESS_INPUT;
+
+        /* Fatal */
+        case Z_STREAM_ERROR:
+            return DECOMPRESS_ERROR;
+
+        /* Corrupted data */
+        default:
+            return DECOMPRESS_DATA;
+    }
+}
+
+InflaterDecompressor::InflaterDecompressor(void)
+{
+    input = nullptr;
+    size = 0;
+    inflater = nullptr;
+    output.size = 0;
+    output.history = 0;
+    output.marker = 0;
+    read = 0;
+    status = DECOMPRESS_OK;
+    adler = adler32(0L, Z_NULL, 0);
+}
+
+InflaterDecompressor::~InflaterDecompressor(void)
+{
+    delete inflater;
+}
+
+const char* InflaterDecompressor::GetName(void)
+{
+    return "inflater";
+}
+
+void InflaterDecompressor::SetInput(const void *input, size_t size)
+{
+    if (inflater != nullptr)
+    {
+        throw std::exception("The inflater needs all input at once.\n");
+    }
+
+    this->input = (const uint8_t*)input;
+    this->size = size;
+    if (!CheckHeader(this->input, size))
+    {
+        status = DECOMPRESS_DATA;
+        return;
+    }
+
+    inflater = new Inflater(this->input + 2, size - 2);
+    output.data.resize(INFLATE_WINDOW + 0x40000);
+}
+
+int InflaterDecompressor::Decompress(void *dest, int size, int *written)
+{
+    size_t length, before;
+    int result;
+
+    *written = 0;
+    if (inflater == nullptr)
+    {
+        return (status == DECOMPRESS_OK) ? DECOMPRESS_INPUT : status;
+    }
+
+    while (*written < size)
+    {
+        /* Hand out what is left of the last block. */
+        if (read < output.size)
+        {
+            length = output.size - read;
+            length = (length < (size_t)(size - *written)) ? length : (size_t)(size - *written);
+            std::memcpy((char*)dest + *written, output.data.data() + read, length);
+            read += length;
+            *written += (int)length;
+            continue;
+        }
+
+        if (status != DECOMPRESS_OK)
+        {
+            break;
+        }
+
+        /* Keep the last 32K as window for the next block. */
+        if (output.size > INFLATE_WINDOW)
+        {
+            std::memmove(output.data.data(), output.data.data() + output.size - INFLATE_WINDOW, INFLATE_WINDOW);
+            output.size = INFLATE_WINDOW;
+            read = INFLATE_WINDOW;
+        }
+
+        before = output.size;
+        result = inflater->ReadHeader();
+        if (result == INFLATE_OK)
+        {
+            result = inflater->ReadBlock(&output);
+        }
+        if (result == INFLATE_ERROR)
+        {
+            status = DECOMPRESS_DATA;
+            break;
+        }
+
+        adler = adler32(adler, output.data.data() + before, (uInt)(output.size - before));
+        if (result == INFLATE_END)
+        {
+            status = CheckTrailer(input, this->size, inflater->Tell(), adler) ? DECOMPRESS_END : DECOMPRESS_DATA;
+        }
+    }
+
+    return (read < output.size) ? DECOMPRESS_OK : status;
+}
+
+OneShotDecompressor::OneShotDecompressor(void)
+{
+    input = nullptr;
+    size = 0;
+    output.size = 0;
+    output.history = 0;
+    output.marker = 0;
+    read = 0;
+    status = DECOMPRESS_INPUT;
+}
+
+OneShotDecompressor::~OneShotDecompressor(void)
+{
+    // Nothing to release.
+}
+
+const char* OneShotDecompressor::GetName(void)
+{
+    return "oneshot";
+}
+
+/**
+ * Takes the whole input and inflates it right away.
+ */
+void OneShotDecompressor::SetInput(const void *input, size_t size)
+{
+    unsigned long adler;
+    size_t length;
+    int result;
+
+    if (this->input != nullptr)
+    {
+        throw std::exception("The one shot inflater needs all input at once.\n");
+    }
+
+    this->input = (const uint8_t*)input;
+    this->size = size;
+    if (!CheckHeader(this->input, size))
+    {
+        status = DECOMPRESS_DATA;
+        return;
+    }
+
+    Inflater inflater(this->input + 2, size - 2);
+
+    // Deflate mostly gets fast file data to about a quarter.
+    output.data.resize(size * 4);
+    do
+    {
+        result = inflater.ReadHeader();
+        if (result == INFLATE_OK)
+        {
+            result = inflater.ReadBlock(&output);
+        }
+    }
+    while (result == INFLATE_OK);
+
+    if (result == INFLATE_ERROR)
+    {
+        status = DECOMPRESS_DATA;
+        return;
+    }
+
+    adler = adler32(0L, Z_NULL, 0);
+    for (size_t offset = 0; offset < output.size; offset += 0x40000000)
+    {
+        length = output.size - offset;
+        adler = adler32(adler, output.data.data() + offset, (uInt)((length < 0x40000000) ? length : 0x40000000));
+    }
+
+    status = CheckTrailer(this->input, size, inflater.Tell(), adler) ? DECOMPRESS_END : DECOMPRESS_DATA;
+}
+
+int OneShotDecompressor::Decompress(void *dest, int size, int *written)
+{
+    size_t length;
+
+    length = output.size - read;
+    length = (length < (size_t)size) ? length : (size_t)size;
+    std::memcpy(dest, output.data.data() + read, length);
+    read += length;
+    *written = (int)length;
+
+    return (read < output.size) ? DECOMPRESS_OK : status;
+}
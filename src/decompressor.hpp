@@ -0,0 +1,105 @@
+#ifndef DECOMPRESSOR_HPP
+#define DECOMPRESSOR_HPP
+
+#include <cstdio>
+#include <cstdint>
+#include <zlib.h>
+#include "inflater.hpp"
+#include "zindex.hpp"
+
+#define DECOMPRESS_OK           0
+#define DECOMPRESS_END          1           /* All data has been decompressed. */
+#define DECOMPRESS_INPUT        2           /* More input is needed. */
+#define DECOMPRESS_ERROR        (-1)        /* Fatal, e.g. out of memory. */
+#define DECOMPRESS_DATA         (-2)        /* Corrupted data. */
+
+#define DECOMPRESSOR_ZLIB       0
+#define DECOMPRESSOR_INFLATER   1
+#define DECOMPRESSOR_ONESHOT    2
+#define DECOMPRESSOR_COUNT      3
+
+/**
+ * Backend which inflates a ZLib stream for a ZLibStream. Backends are picked
+ * at runtime through Create(), e.g. to compare their throughput.
+ */
+class Decompressor
+{
+public:
+    virtual ~Decompressor(void);
+
+    static Decompressor* Create(int type);
+
+    virtual const char* GetName(void) = 0;
+    virtual void SetInput(const void *input, size_t size) = 0;
+    virtual int Decompress(void *dest, int size, int *written) = 0;
+    virtual bool SetIndex(ZIndex *index);
+};
+
+/** The vendored ZLib, the only backend which can read input in parts. */
+class ZLibDecompressor : public Decompressor
+{
+public:
+    ZLibDecompressor(void);
+    ~ZLibDecompressor(void);
+
+    const char* GetName(void);
+    void SetInput(const void *input, size_t size);
+    int Decompress(void *dest, int size, int *written);
+    bool SetIndex(ZIndex *index);
+
+private:
+    int Inflate(void);
+
+private:
+    z_stream zStruct;
+    ZIndex *index;
+};
+
+/**
+ * The Inflater, block by block. Keeps the last 32K of output as window and
+ * needs the whole input at once.
+ */
+class InflaterDecompressor : public Decompressor
+{
+public:
+    InflaterDecompressor(void);
+    ~InflaterDecompressor(void);
+
+    const char* GetName(void);
+    void SetInput(const void *input, size_t size);
+    int Decompress(void *dest, int size, int *written);
+
+private:
+    const uint8_t *input;
+    size_t size;
+    Inflater *inflater;
+    InflateOutput<uint8_t> output;
+    size_t read;
+    int status;
+    unsigned long adler;
+};
+
+/**
+ * The Inflater over the whole input in one go, e.g. a mapped file. The output
+ * is never moved, hence no window has to be kept, at the cost of holding all
+ * of it in memory.
+ */
+class OneShotDecompressor : public Decompressor
+{
+public:
+    OneShotDecompressor(void);
+    ~OneShotDecompressor(void);
+
+    const char* GetName(void);
+    void SetInput(const void *input, size_t size);
+    int Decompress(void *dest, int size, int *written);
+
+private:
+    const uint8_t *input;
+    size_t size;
+    InflateOutput<uint8_t> output;
+    size_t read;
+    int status;
+};
+
+#endif /* DECOMPRESSOR_HPP */
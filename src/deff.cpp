@@ -1,9 +1,73 @@
 #include <cstdio>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
 #include <zlib.h>
 #include "utility.hpp"
 #include "version.h"
 #include "fastfile.hpp"
+#include "exporter.hpp"
+#include "asset.hpp"
+
+#include <Psapi.h>
+
+/** What to do with each file. */
+struct Options
+{
+    bool list;                              // Scan and list the assets
+    bool diff;                              // Load checked and unchecked, and compare
+    bool trace;                             // Print the stack trace of a failed load, unless --no-trace
+    std::vector<struct FileDigest> manifest; // Trusted files, sorted by CompareDigests
+    const wchar_t *directory;               // Where to export the models, weapons and sounds, or nullptr
+};
+
+/** A file of a batch, with its console output until it is its turn. */
+struct Job
+{
+    const wchar_t *path;
+    long long size;                         // Compressed
+    long long memory;                       // Taken while loading
+    const struct Options *options;
+    struct Batch *batch;                    // Charged for the memory, or nullptr
+    std::string output;                     // stdout
+    std::string error;                      // stderr
+    bool done;
+};
+
+/** The queue of a worker; others steal from it once their own is empty. */
+struct Worker
+{
+    std::mutex lock;
+    std::deque<struct Job*> queue;
+};
+
+/** The memory the loads in flight may take together. */
+struct Budget
+{
+    long long limit;                        // 0 for no limit
+    long long used;
+    long long peak;
+};
+
+struct Batch
+{
+    std::vector<struct Job> jobs;
+    std::vector<struct Worker> workers;
+    std::mutex lock;
+    std::condition_variable finished;
+    std::condition_variable released;       // Budget
+    unsigned long long releases;            // Counts the releases, a taker waits for the next
+    struct Budget budget;
+};
 
 
 
@@ -24,71 +88,693 @@ int getMaxSize(int argc, wchar_t **argv)
     return size + 3;
 }
 
+/**
+ * Appends formatted text to the output of a job.
+ */
+static void Append(std::string *output, const char *format, ...)
+{
+    std::va_list argptr;
+    int length;
 
-int wmain(int argc, wchar_t **argv)
+    va_start(argptr, format);
+    length = std::vsnprintf(nullptr, 0, format, argptr);
+    va_end(argptr);
+
+    if (length > 0)
+    {
+        std::vector<char> text(length + 1);
+
+        va_start(argptr, format);
+        std::vsnprintf(text.data(), text.size(), format, argptr);
+        va_end(argptr);
+
+        output->append(text.data(), length);
+    }
+}
+
+/**
+ * Gets the size of a fast file on disk, or 0 when it can not be opened. The
+ * load reports the error later on.
+ */
+static long long GetCompressedSize(const wchar_t *path)
 {
-    std::fprintf(stdout, "DEFF: %s\n", DEFF_VERSION_LONG);
+    LARGE_INTEGER length;
+    HANDLE file;
 
-#ifdef DEBUG
-    std::fprintf(stderr, "DEFF: %s\nZLIB: %s\n", DEFF_VERSION_LONG, zlibVersion());
-#endif
+    file = CreateFileW(
+        path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return 0;
+    }
+
+    if (!GetFileSizeEx(file, &length))
+    {
+        length.QuadPart = 0;
+    }
 
-    if (argc < 2)
+    CloseHandle(file);
+    return length.QuadPart;
+}
+
+/**
+ * Estimates the memory a load takes from the header; the data plus the mapped
+ * file. Files which can not be probed are 0, the load reports the error.
+ */
+static long long GetMemory(const wchar_t *path, long long size)
+{
+    try
+    {
+        FastFile ff(path);
+
+        return (ff.ProbeDataSize() + size);
+    }
+    catch (const std::exception &)
     {
-        fputs("USAGE: deff.exe < files >\n", stdout);
         return 0;
     }
+}
 
-    int maxSize = getMaxSize(argc - 1, argv + 1);
+/**
+ * Charges the budget of the batch for a job when it has no limit, as then the
+ * estimate is only reported. It is taken from the file the load opened rather
+ * than up front on the main thread. Files which can not be probed are 0, the
+ * load reports the error.
+ * @param ff The fast file of the job, opened but not loaded.
+ */
+static void Charge(struct Job *job, FastFile *ff)
+{
+    long long memory;
+
+    if (job->batch == nullptr || job->batch->budget.limit != 0)
+    {
+        return;
+    }
+
+    try
+    {
+        memory = ff->ProbeDataSize() + job->size;
+    }
+    catch (const std::exception &)
+    {
+        memory = 0;
+    }
+
+    std::lock_guard<std::mutex> guard(job->batch->lock);
+    job->memory = memory;
+    job->batch->budget.used += memory;
+    if (job->batch->budget.used > job->batch->budget.peak)
+    {
+        job->batch->budget.peak = job->batch->budget.used;
+    }
+}
+
+/**
+ * Gets the peak working set of the process in bytes.
+ */
+static long long GetPeakWorkingSet(void)
+{
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+
+    return (long long)counters.PeakWorkingSetSize;
+}
+
+/**
+ * Orders the files of a manifest by their hash, then by their size.
+ */
+static bool CompareDigests(const struct FileDigest &a, const struct FileDigest &b)
+{
+    int order = memcmp(a.hash, b.hash, DIGEST_SIZE);
+
+    return (order < 0) || (order == 0 && a.size < b.size);
+}
+
+/**
+ * Gets the value of a hexadecimal digit, -1 when it is none.
+ */
+static int GetHexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return (c - '0');
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return (c - 'a' + 10);
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return (c - 'A' + 10);
+    }
+    return -1;
+}
+
+/**
+ * Reads a manifest of trusted files; the SHA-256 in hexadecimal and the size
+ * in bytes per line, which may be followed by the name. Empty lines and lines
+ * starting with # are skipped.
+ * @return true if it could be read; otherwise, false.
+ */
+static bool LoadManifest(const wchar_t *path, std::vector<struct FileDigest> *manifest)
+{
+    std::FILE *file;
+    char line[MAX_PATH + 128];
+    struct FileDigest digest;
+    char *end;
+    bool failed = false;
+
+    if (_wfopen_s(&file, path, L"r") != 0)
+    {
+        return false;
+    }
+
+    while (!failed && fgets(line, sizeof(line), file) != nullptr)
+    {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || line[0] == 0)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < DIGEST_SIZE && !failed; i++)
+        {
+            int high = GetHexValue(line[i * 2]);
+            int low = (high >= 0) ? GetHexValue(line[i * 2 + 1]) : -1;
+
+            failed = (high < 0 || low < 0);
+            digest.hash[i] = (unsigned char)((high << 4) | low);
+        }
+
+        // A line which is not of the format is an error, not a file less.
+        if (!failed)
+        {
+            failed = (line[DIGEST_SIZE * 2] != ' ' && line[DIGEST_SIZE * 2] != '\t');
+        }
+        if (!failed)
+        {
+            digest.size = strtoll(&line[DIGEST_SIZE * 2], &end, 10);
+            failed = (end == &line[DIGEST_SIZE * 2] || digest.size < 0);
+        }
+        if (!failed)
+        {
+            manifest->push_back(digest);
+        }
+    }
+
+    fclose(file);
+    std::sort(manifest->begin(), manifest->end(), CompareDigests);
+    return !failed;
+}
+
+/**
+ * Loads a file with the validation and without, and compares the two.
+ */
+static void DiffFile(struct Job *job)
+{
+    FastFile checked(job->path), unchecked(job->path);
+
+    Charge(job, &checked);
+
+    auto start = std::chrono::steady_clock::now();
+    checked.Load();
+    auto middle = std::chrono::steady_clock::now();
+    unchecked.Load(LOAD_TRUSTED);
+    auto end = std::chrono::steady_clock::now();
+
+    Append(&job->output, "%s (checked %.3f s, unchecked %.3f s)\n",
+        checked.IsIdentical(&unchecked) ? "SAME" : "DIFFERENT",
+        std::chrono::duration<double>(middle - start).count(),
+        std::chrono::duration<double>(end - middle).count());
+}
+
+/**
+ * Exports the assets of a loaded file which can be; models, weapons and
+ * sounds. Each asset writes its own files, or rows of a table which the
+ * assets of its type share.
+ */
+static void ExportAssets(FastFile *ff, const wchar_t *directory, struct Job *job)
+{
+    Exporter exporter(directory, job->path);
+
+    for (int i = 0; i < ff->GetAssetCount(); i++)
+    {
+        ff->GetAsset(i)->Export(ff, &exporter);
+    }
+    exporter.Close();
+
+    Append(&job->output, "    %i files exported\n", exporter.GetFileCount());
+}
+
+/**
+ * Loads a fast file, keeping the status and any exception in the job.
+ */
+static void LoadFile(struct Job *job)
+{
+    try
+    {
+        int flags = LOAD_DEFAULT;
+
+        if (job->options->diff)
+        {
+            DiffFile(job);
+            return;
+        }
+
+        // On the stack, hence a failed load releases the file and its threads.
+        FastFile ff(job->path);
+        Charge(job, &ff);
+
+        // Files in the manifest are known good and skip the validation.
+        if (!job->options->manifest.empty())
+        {
+            struct FileDigest digest;
+
+            ff.GetDigest(&digest);
+            if (std::binary_search(job->options->manifest.begin(), job->options->manifest.end(), digest, CompareDigests))
+            {
+                flags |= LOAD_TRUSTED;
+            }
+        }
+
+        if (job->options->list)
+        {
+            std::vector<struct AssetInfo> assets;
+
+            ff.Scan(&assets, flags);
+            Append(&job->output, "SUCCESS\n");
+            for (const struct AssetInfo &asset : assets)
+            {
+                Append(&job->output, "    %-16s 0x%08X %10i  %s\n",
+                    lpAssetType[asset.type], asset.offset, asset.size,
+                    (asset.name != nullptr) ? asset.name : "");
+            }
+        }
+        else
+        {
+            ff.Load(flags);
+            Append(&job->output, (flags & LOAD_TRUSTED) ? "SUCCESS (trusted)\n" : "SUCCESS\n");
+            if (job->options->directory != nullptr)
+            {
+                ExportAssets(&ff, job->options->directory, job);
+            }
+        }
+    }
+    catch (const Exception &ex)
+    {
+        Append(&job->output, "FAILED\n");
+        Append(&job->error, "\nEXCEPTION\n\t%ls\n\t%s\n", job->path, ex.what());
+
+        // Symbolizing is slow and serialized, a sweep over broken files may skip it.
+        if (job->options->trace)
+        {
+            const struct StackTrace &trace = ex.stackTrace();
+
+            Append(&job->error, "\n==== STACK TRACE (%i) ============================\n", trace.argc);
+            for (int e = 0; e < trace.argc; e++)
+            {
+                Append(&job->error, "\n%s", trace.argv[e]);
+            }
+            Append(&job->error, "\n==================================================\n");
+        }
+        else
+        {
+            Append(&job->error, "\n");
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        Append(&job->output, "FAILED\n");
+        Append(&job->error, "\nEXCEPTION\n\t%ls\n\t%s\n\n", job->path, ex.what());
+    }
+}
+
+/**
+ * Prints the status and any exception of a job.
+ */
+static void PrintJob(const struct Job *job)
+{
+    fputs(job->output.c_str(), stdout);
+    fflush(stdout);
+
+    if (!job->error.empty())
+    {
+        fputs(job->error.c_str(), stderr);
+        fflush(stderr);
+    }
+}
+
+/**
+ * Checks whether a job fits in the budget. A job larger than the whole budget
+ * is only admitted on its own.
+ */
+static bool Fits(const struct Budget *budget, const struct Job *job)
+{
+    return (budget->limit == 0 || budget->used == 0 || (budget->used + job->memory) <= budget->limit);
+}
+
+/**
+ * Admits a job when it fits in the budget, and charges the budget for it.
+ * Without a budget every job fits, and is charged once its file is open, see
+ * Charge.
+ */
+static bool Admit(struct Batch *batch, struct Job *job)
+{
+    if (batch->budget.limit == 0)
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> guard(batch->lock);
+    if (!Fits(&batch->budget, job))
+    {
+        return false;
+    }
+
+    batch->budget.used += job->memory;
+    if (batch->budget.used > batch->budget.peak)
+    {
+        batch->budget.peak = batch->budget.used;
+    }
+    return true;
+}
+
+/**
+ * Takes the next job which fits in the budget; from the own queue first, then
+ * from the others. Queues are ordered largest first and both ends take from
+ * the front, so the largest remaining zones are never left for last. Jobs
+ * which do not fit wait in their queue until memory has been released. Only
+ * the queue being looked at is locked, the budget only while it is charged.
+ * @param self The index of the worker.
+ * @return The job, or nullptr once all queues are empty.
+ */
+static struct Job* TakeJob(struct Batch *batch, size_t self)
+{
+    struct Job *job;
+    unsigned long long seen;
+    bool remaining;
+
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> guard(batch->lock);
+            seen = batch->releases;
+        }
+        remaining = false;
+
+        for (size_t n = 0; n < batch->workers.size(); n++)
+        {
+            struct Worker &worker = batch->workers[(self + n) % batch->workers.size()];
+            std::lock_guard<std::mutex> guard(worker.lock);
+
+            for (auto it = worker.queue.begin(); it != worker.queue.end(); ++it)
+            {
+                if (Admit(batch, *it))
+                {
+                    job = *it;
+                    worker.queue.erase(it);
+                    return job;
+                }
+            }
+
+            remaining = remaining || !worker.queue.empty();
+        }
+
+        if (!remaining)
+        {
+            return nullptr;
+        }
+
+        // Memory released since the scan began makes it worth another scan.
+        std::unique_lock<std::mutex> guard(batch->lock);
+        batch->released.wait(guard, [batch, seen]() { return batch->releases != seen; });
+    }
+}
+
+static void Work(struct Batch *batch, size_t self)
+{
+    struct Job *job;
+
+    while ((job = TakeJob(batch, self)) != nullptr)
+    {
+        LoadFile(job);
+
+        {
+            std::lock_guard<std::mutex> guard(batch->lock);
+            job->done = true;
+            batch->budget.used -= job->memory;
+            batch->releases++;
+        }
+        batch->finished.notify_all();
+        batch->released.notify_all();
+    }
+}
+
+/**
+ * Loads the files on a number of threads and reports them in order, each as
+ * soon as it and all before it are done. At the end the throughput and the
+ * memory are reported.
+ * @param jobs The number of threads.
+ * @param budget The memory the loads in flight may take together, 0 for no
+ *               limit.
+ * @param options What to do with each file.
+ */
+static void LoadBatch(int argc, wchar_t **argv, int jobs, long long budget, const struct Options *options)
+{
+    std::vector<struct Job*> order;
+    std::vector<std::thread> threads;
+    struct Batch batch;
+    long long compressed = 0, memory = 0;
+    double seconds;
+
+    auto start = std::chrono::steady_clock::now();
+
+    int maxSize = getMaxSize(argc, argv);
     wchar_t *filepath = new wchar_t[maxSize];
 
-    for (int i = 1; i < argc; i++)
+    batch.jobs.resize(argc);
+    for (int i = 0; i < argc; i++)
+    {
+        batch.jobs[i].path = argv[i];
+        batch.jobs[i].size = GetCompressedSize(argv[i]);
+        batch.jobs[i].memory = (budget != 0) ? GetMemory(argv[i], batch.jobs[i].size) : 0;
+        batch.jobs[i].options = options;
+        batch.jobs[i].batch = &batch;
+        batch.jobs[i].done = false;
+        order.push_back(&batch.jobs[i]);
+
+        compressed += batch.jobs[i].size;
+    }
+    batch.releases = 0;
+    batch.budget.limit = budget;
+    batch.budget.used = 0;
+    batch.budget.peak = 0;
+
+    // Deal the files largest first over the workers.
+    std::stable_sort(order.begin(), order.end(),
+        [](const struct Job *a, const struct Job *b) { return a->size > b->size; });
+
+    if (jobs > argc)
+    {
+        jobs = argc;
+    }
+    batch.workers = std::vector<struct Worker>(jobs);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        batch.workers[i % jobs].queue.push_back(order[i]);
+    }
+
+    for (int i = 0; i < jobs; i++)
+    {
+        threads.emplace_back(Work, &batch, (size_t)i);
+    }
+
+    for (int i = 0; i < argc; i++)
     {
         for (int i = 0; i < maxSize; i++)
             filepath[i] = L'.';
         memcpy_s(filepath, maxSize * sizeof(wchar_t), argv[i],
             (wcslen(argv[i]) * sizeof(wchar_t)));
 
+        {
+            std::unique_lock<std::mutex> guard(batch.lock);
+            batch.finished.wait(guard, [&]() { return batch.jobs[i].done; });
+            memory += batch.jobs[i].memory;
+        }
+
         fprintf(stdout, "Loading %-*ls", maxSize, filepath);
-        fflush(stdout);
+        PrintJob(&batch.jobs[i]);
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stdout, "\n%i files, %i threads, %.2f s, %.1f MiB/s compressed, %.1f MiB/s loaded\n",
+        argc, jobs, seconds,
+        (seconds > 0.0) ? ((double)compressed / seconds / 1048576.0) : 0.0,
+        (seconds > 0.0) ? ((double)memory / seconds / 1048576.0) : 0.0);
+    fprintf(stdout, "Memory: %.1f MiB budget, %.1f MiB peak estimate, %.1f MiB peak working set\n",
+        (double)budget / 1048576.0, (double)batch.budget.peak / 1048576.0,
+        (double)GetPeakWorkingSet() / 1048576.0);
+
+    delete[] filepath;
+}
+
+
+int wmain(int argc, wchar_t **argv)
+{
+    struct Options options;
+    long long budget = 0;
+    wchar_t *end;
+    long number;
+    int jobs = 1;
+
+    std::fprintf(stdout, "DEFF: %s\n", DEFF_VERSION_LONG);
+
+#ifdef DEBUG
+    std::fprintf(stderr, "DEFF: %s\nZLIB: %s\n", DEFF_VERSION_LONG, zlibVersion());
+#endif
+
+    options.list = false;
+    options.diff = false;
+    options.trace = true;
+    options.directory = nullptr;
 
-        try
+    // Options for a batch, each with a number but --list, --diff, --no-trace, --trust and --export.
+    while (argc >= 2 && wcsncmp(argv[1], L"--", 2) == 0)
+    {
+        // Only list the assets of each file.
+        if (wcscmp(argv[1], L"--list") == 0)
         {
-            FastFile *ff = new FastFile(argv[i]);
-            if (ff)
-            {
-                ff->Load();
-                fputs("SUCCESS\n", stdout);
-                delete ff;
-            }
-            else
+            options.list = true;
+            argc -= 1;
+            argv += 1;
+            continue;
+        }
+
+        // Load each file with and without validation and compare.
+        if (wcscmp(argv[1], L"--diff") == 0)
+        {
+            options.diff = true;
+            argc -= 1;
+            argv += 1;
+            continue;
+        }
+
+        // Skip the stack trace of each failed load.
+        if (wcscmp(argv[1], L"--no-trace") == 0)
+        {
+            options.trace = false;
+            argc -= 1;
+            argv += 1;
+            continue;
+        }
+
+        if (argc < 3)
+        {
+            jobs = -1;
+            break;
+        }
+
+        // Skip the validation of the files in a manifest.
+        if (wcscmp(argv[1], L"--trust") == 0)
+        {
+            if (!LoadManifest(argv[2], &options.manifest))
             {
-                fputs("FAILED\n", stdout);
-                fprintf(stderr, "Could not create FastFile object for '%ls'.\n", argv[i]);
+                fprintf(stderr, "Could not read the manifest '%ls'.\n", argv[2]);
+                return 1;
             }
+
+            argc -= 2;
+            argv += 2;
+            continue;
         }
-        catch (const Exception &ex)
+
+        // Export the models, weapons and sounds of each file to a directory.
+        if (wcscmp(argv[1], L"--export") == 0)
         {
-            const struct StackTrace &trace = ex.stackTrace();
+            options.directory = argv[2];
+            argc -= 2;
+            argv += 2;
+            continue;
+        }
 
-            fputs("FAILED\n", stdout);
-            fprintf(stderr, "\nEXCEPTION\n\t%ls\n\t%s\n", argv[i], ex.what());
+        number = wcstol(argv[2], &end, 10);
+        if (*end != 0 || number < 0)
+        {
+            jobs = -1;
+            break;
+        }
 
-            fprintf(stderr, "\n==== STACK TRACE (%i) ============================\n", trace.argc);
-            for (int e = 0; e < trace.argc; e++)
+        // Load several files at once, 0 for all cores.
+        if (wcscmp(argv[1], L"--jobs") == 0)
+        {
+            jobs = (int)number;
+            if (jobs == 0)
             {
-                fprintf(stderr, "\n%s", trace.argv[e]);
+                jobs = (int)std::thread::hardware_concurrency();
+                jobs = (jobs > 0) ? jobs : 1;
             }
-            fputs("\n==================================================\n", stderr);
-
-            fflush(stderr);
         }
-        catch (const std::exception &ex)
+        // Memory of the loads in flight in MiB, 0 for no limit.
+        else if (wcscmp(argv[1], L"--budget") == 0)
+        {
+            budget = (long long)number * 1048576;
+        }
+        else
         {
-            fputs("FAILED\n", stdout);
-            fprintf(stderr, "\nEXCEPTION\n\t%ls\n\t%s\n\n", argv[i], ex.what());
-            fflush(stderr);
+            jobs = -1;
+            break;
         }
+
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (argc < 2 || jobs < 1)
+    {
+        fputs("USAGE: deff.exe [ --list | --diff ] [ --no-trace ] [ --trust < manifest > ] [ --export < directory > ] [ --jobs < threads > ] [ --budget < MiB > ] < files >\n", stdout);
+        return 0;
+    }
+
+    if (jobs > 1 || budget > 0)
+    {
+        LoadBatch(argc - 1, argv + 1, jobs, budget, &options);
+        return 0;
+    }
+
+    int maxSize = getMaxSize(argc - 1, argv + 1);
+    wchar_t *filepath = new wchar_t[maxSize];
+
+    for (int i = 1; i < argc; i++)
+    {
+        struct Job job;
+
+        for (int i = 0; i < maxSize; i++)
+            filepath[i] = L'.';
+        memcpy_s(filepath, maxSize * sizeof(wchar_t), argv[i],
+            (wcslen(argv[i]) * sizeof(wchar_t)));
+
+        fprintf(stdout, "Loading %-*ls", maxSize, filepath);
+        fflush(stdout);
+
+        job.path = argv[i];
+        job.size = 0;
+        job.memory = 0;
+        job.options = &options;
+        job.batch = nullptr;
+        job.done = false;
+
+        LoadFile(&job);
+        PrintJob(&job);
     }
 
     delete[] filepath;
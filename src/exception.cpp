@@ -1,6 +1,7 @@
 #include <stdexcept>
 #include <cstdio>
 #include <cstdarg>
+#include <mutex>
 
 #include <Windows.h>
 #include <dbghelp.h>
@@ -16,11 +17,27 @@
 
 
 
-static void _StackTrace(struct StackTrace *trace)
+// DbgHelp is single threaded, while batches throw on several threads.
+static std::mutex symbols;
+static bool initialized = false;
+
+/**
+ * Captures the return addresses only, which is cheap enough for every throw.
+ */
+static void _CaptureTrace(struct StackTrace *trace)
+{
+    trace->frames = CaptureStackBackTrace(NUM_SKIP_FRAMES, MAX_STACK_FRAMES, trace->stack, NULL);
+    trace->symbolized = false;
+    trace->argc = 0;
+}
+
+/**
+ * Turns the captured addresses into text. The symbols are loaded on the
+ * first trace that is printed, and kept for the rest.
+ */
+static void _SymbolizeTrace(struct StackTrace *trace)
 {
-    unsigned int    i;
-    void            *stack[MAX_STACK_FRAMES];
-    unsigned short  frames;
+    int             i;
     HANDLE          process;
     DWORD           displacement;
     DWORD64         dwAddress;
@@ -29,56 +46,62 @@ static void _StackTrace(struct StackTrace *trace)
     PSYMBOL_INFO    symbol = (PSYMBOL_INFO)buffer;
     int             length;
 
+    std::lock_guard<std::mutex> guard(symbols);
+
     // Defaults
     trace->argc = 0;
+    trace->symbolized = true;
 
     process = GetCurrentProcess();
-    if (SymInitialize(process, NULL, TRUE) == TRUE)
+    if (!initialized)
     {
+        if (SymInitialize(process, NULL, TRUE) != TRUE)
+        {
+            return;
+        }
+
         SymSetOptions(SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
-        frames = CaptureStackBackTrace(NUM_SKIP_FRAMES, MAX_STACK_FRAMES, stack, NULL);
-        
-        symbol->MaxNameLen   = (MAX_STACK_LENGTH - 1); // MSDN: minus for the zero-terminator
-        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
-        line.SizeOfStruct    = sizeof(IMAGEHLP_LINE64);
+        initialized = true;
+    }
 
-        for (i = 0; i < frames; i++)
-        {
-            dwAddress = (DWORD64)(stack[i]);
+    symbol->MaxNameLen   = (MAX_STACK_LENGTH - 1); // MSDN: minus for the zero-terminator
+    symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+    line.SizeOfStruct    = sizeof(IMAGEHLP_LINE64);
 
-            // Load the all the information we wish to display.
-            if (SymGetLineFromAddr64(process, dwAddress, &displacement, &line) == TRUE &&
-                SymFromAddr(process, dwAddress, NULL, symbol) == TRUE)
+    for (i = 0; i < trace->frames; i++)
+    {
+        dwAddress = (DWORD64)(trace->stack[i]);
+
+        // Load the all the information we wish to display.
+        if (SymGetLineFromAddr64(process, dwAddress, &displacement, &line) == TRUE &&
+            SymFromAddr(process, dwAddress, NULL, symbol) == TRUE)
+        {
+            // Print it formatted into the buffer.
+            length = std::snprintf(
+                trace->argv[trace->argc],
+                MAX_STACK_LENGTH, TRACE_FORMAT,
+                line.FileName, line.LineNumber, symbol->Address, symbol->Name
+            );
+
+            // Cap the length
+            if (length > MAX_STACK_LENGTH)
             {
-                // Print it formatted into the buffer.
-                length = std::snprintf(
-                    trace->argv[trace->argc],
-                    MAX_STACK_LENGTH, TRACE_FORMAT,
-                    line.FileName, line.LineNumber, symbol->Address, symbol->Name
-                );
-
-                // Cap the length
-                if (length > MAX_STACK_LENGTH)
-                {
-                    length = MAX_STACK_LENGTH;
-                }
-
-                // Store the values.
-                trace->length[trace->argc] = length;
-                trace->argv[trace->argc][MAX_STACK_LENGTH - 1] = 0;
-                trace->argc++;
+                length = MAX_STACK_LENGTH;
             }
-            else
+
+            // Store the values.
+            trace->length[trace->argc] = length;
+            trace->argv[trace->argc][MAX_STACK_LENGTH - 1] = 0;
+            trace->argc++;
+        }
+        else
+        {
+            // This error occurs when the .pdb file has not been found.
+            if (GetLastError() == ERROR_INVALID_ADDRESS)
             {
-                // This error occurs when the .pdb file has not been found.
-                if (GetLastError() == ERROR_INVALID_ADDRESS)
-                {
-                    break;
-                }
+                break;
             }
         }
-
-        SymCleanup(process);
     }
 
     // NOTE: Not currently needed because of the 'virtual' handle value. But may
@@ -93,8 +116,8 @@ Exception::Exception(const char *format, ...) :
 {
     std::va_list argptr;
 
-    // Generate the trace data
-    _StackTrace(&trace);
+    // Capture the trace, it is symbolized when asked for.
+    _CaptureTrace(&trace);
 
     // Print the format message.
     va_start(argptr, format);
@@ -116,8 +139,8 @@ Exception::Exception(int line, const char *file, const char *format, ...) :
     char local[MAX_MESSAGE_LENGTH];
     char *cat;
 
-    // Generate the trace data
-    _StackTrace(&trace);
+    // Capture the trace, it is symbolized when asked for.
+    _CaptureTrace(&trace);
 
     // First create the prefix
     std::snprintf(local, MAX_MESSAGE_LENGTH, MESSAGE_PREFIX, file, line);
@@ -155,5 +178,10 @@ const char * Exception::what(void) const noexcept
 
 const struct StackTrace& Exception::stackTrace(void) const noexcept
 {
+    if (!trace.symbolized)
+    {
+        _SymbolizeTrace(&trace);
+    }
+
     return trace;
 }
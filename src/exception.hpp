@@ -10,15 +10,22 @@
 #define MAX_STACK_LENGTH        256     /* Maximum length per string for each frame. */
 #define MAX_MESSAGE_LENGTH      512     /* Maximum length of the default .what() message. */
 
+/**
+ * The return addresses of a throw, which are only turned into text when the
+ * trace is asked for. Most exceptions are caught without ever printing it.
+ */
 struct StackTrace
 {
 public:
     StackTrace(void)
     {
         argc = 0;
+        frames = 0;
+        symbolized = false;
         for (int i = 0; i < MAX_STACK_FRAMES; i++)
         {
             argv[i][0] = '\0';
+            stack[i] = nullptr;
         }
     }
 
@@ -32,12 +39,20 @@ public:
         argc = other.argc;
         memcpy(argv, other.argv, (sizeof(char) * MAX_STACK_FRAMES * MAX_STACK_LENGTH));
         memcpy(length, other.length, (sizeof(int) * MAX_STACK_FRAMES));
+        memcpy(stack, other.stack, (sizeof(void*) * MAX_STACK_FRAMES));
+        frames = other.frames;
+        symbolized = other.symbolized;
     }
 
 public:
     char argv[MAX_STACK_FRAMES][MAX_STACK_LENGTH];
     int length[MAX_STACK_FRAMES];
     int argc;
+
+    // Captured on the throw, symbolized into the above by stackTrace().
+    void *stack[MAX_STACK_FRAMES];
+    int frames;
+    bool symbolized;
 };
 
 
@@ -52,7 +67,7 @@ public:
 
 protected:
     char message[MAX_MESSAGE_LENGTH];
-    struct StackTrace trace;
+    mutable struct StackTrace trace;
 };
 
 
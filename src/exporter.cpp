@@ -0,0 +1,164 @@
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "utility.hpp"
+#include "writer.hpp"
+#include "exporter.hpp"
+
+/**
+ * Creates an exporter for the assets of a fast file.
+ * @param directory The directory to export to, which must outlive the exporter.
+ * @param path The path of the fast file, its name names the tables.
+ */
+Exporter::Exporter(const wchar_t *directory, const wchar_t *path)
+{
+    const wchar_t *name, *slash, *extension;
+
+    // Windows takes both separators.
+    name = wcsrchr(path, L'\\');
+    slash = wcsrchr(path, L'/');
+    name = (slash != nullptr && (name == nullptr || slash > name)) ? slash : name;
+    name = (name != nullptr) ? (name + 1) : path;
+    extension = wcsrchr(name, L'.');
+
+    this->directory = directory;
+    this->file.assign(name, (extension != nullptr) ? (size_t)(extension - name) : wcslen(name));
+    this->files = 0;
+}
+
+Exporter::~Exporter(void)
+{
+    Release();
+}
+
+/**
+ * Closes the tables without writing what is left, e.g. after an exception.
+ */
+void Exporter::Release(void) noexcept
+{
+    for (struct ExporterTable &table : tables)
+    {
+        delete table.writer;
+    }
+    tables.clear();
+    claimed.clear();
+}
+
+/**
+ * Makes the path of a file named after an asset; its name with the path
+ * separators replaced, then a suffix.
+ */
+void Exporter::GetFilePath(wchar_t *dest, const char *name, const wchar_t *suffix)
+{
+    const char *c;
+    size_t length;
+
+    if (wcscpy_s(dest, MAX_PATH, directory) || wcscat_s(dest, MAX_PATH, L"\\"))
+    {
+        throw Exception("Export path too long for '%s'.", name);
+    }
+
+    length = wcslen(dest);
+    for (c = name; *c != 0 && length < (MAX_PATH - 1); c++, length++)
+    {
+        dest[length] = (*c == '/' || *c == '\\' || *c == ':') ? L'_' : (wchar_t)(unsigned char)*c;
+    }
+    dest[length] = 0;
+
+    if (*c != 0 || wcscat_s(dest, MAX_PATH, suffix))
+    {
+        throw Exception("Export path too long for '%s'.", name);
+    }
+}
+
+/**
+ * Opens a file of an asset, one at a time.
+ * @param name The name of the asset, or of the part of it.
+ * @param suffix What follows the name, e.g. the extension.
+ * @return The writer of the file.
+ */
+class Writer* Exporter::OpenFile(const char *name, const wchar_t *suffix)
+{
+    wchar_t path[MAX_PATH];
+
+    GetFilePath(path, name, suffix);
+    writer.Open(path);
+    files++;
+
+    return &writer;
+}
+
+void Exporter::CloseFile(void)
+{
+    writer.Close();
+}
+
+/**
+ * Opens a table shared by the assets of a type, the first asset creates it.
+ * @param suffix What follows the name of the fast file, e.g. "_weapons.csv".
+ * @param created Receives whether the table was created, hence needs its
+ *                header.
+ * @return The writer of the table.
+ */
+class Writer* Exporter::OpenTable(const wchar_t *suffix, bool *created)
+{
+    wchar_t path[MAX_PATH];
+    struct ExporterTable table;
+
+    for (struct ExporterTable &open : tables)
+    {
+        if (open.suffix == suffix)
+        {
+            *created = false;
+            return open.writer;
+        }
+    }
+
+    if (swprintf(path, MAX_PATH, L"%ls\\%ls%ls", directory, file.c_str(), suffix) < 0)
+    {
+        throw Exception("Export path too long for '%ls'.", file.c_str());
+    }
+
+    table.suffix = suffix;
+    table.writer = new Writer();
+    tables.push_back(table);
+
+    table.writer->Open(path);
+    files++;
+
+    *created = true;
+    return table.writer;
+}
+
+/**
+ * Writes what is left of the tables and closes them.
+ */
+void Exporter::Close(void)
+{
+    for (struct ExporterTable &table : tables)
+    {
+        table.writer->Close();
+    }
+    Release();
+}
+
+/**
+ * Claims data which several assets share, e.g. the samples of a sound used
+ * by a number of aliases, so that it is exported once.
+ * @param data The data, by where it is within the fast file.
+ * @return true the first time; otherwise, false.
+ */
+bool Exporter::Claim(const void *data)
+{
+    return claimed.insert(data).second;
+}
+
+/**
+ * Gets the number of files written, of assets and tables.
+ */
+int Exporter::GetFileCount(void)
+{
+    return files;
+}
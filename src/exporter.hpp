@@ -0,0 +1,53 @@
+#ifndef EXPORTER_HPP
+#define EXPORTER_HPP
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "utility.hpp"
+#include "writer.hpp"
+
+struct ExporterTable
+{
+    std::wstring suffix;
+    class Writer *writer;
+};
+
+/**
+ * Where the assets of a fast file export to, see Asset::Export. An asset
+ * either writes files of its own, named after it, or rows of a table which
+ * all assets of its type share, named after the fast file.
+ */
+class Exporter
+{
+public:
+    Exporter(const wchar_t *directory, const wchar_t *path);
+    ~Exporter(void);
+    void Release(void) noexcept;
+
+    // A file of its own, open until CloseFile
+    class Writer* OpenFile(const char *name, const wchar_t *suffix);
+    void CloseFile(void);
+
+    // A table, open until Close
+    class Writer* OpenTable(const wchar_t *suffix, bool *created);
+    void Close(void);
+
+    // Whether data shared by assets is yet to be exported
+    bool Claim(const void *data);
+
+    int GetFileCount(void);
+
+private:
+    void GetFilePath(wchar_t *dest, const char *name, const wchar_t *suffix);
+
+private:
+    const wchar_t *directory;
+    std::wstring file;                  // The fast file without its directory and extension
+    class Writer writer;
+    std::vector<struct ExporterTable> tables;
+    std::unordered_set<const void*> claimed;
+    int files;
+};
+
+#endif /* EXPORTER_HPP */
@@ -1,24 +1,38 @@
 #include <cstdio>
 #include <exception>
 #include <new>
+#include <thread>
+
+#include <Windows.h>
+#include <bcrypt.h>
+#pragma comment(lib, "Bcrypt.lib")
+
+#if defined(_M_X64) || (defined(__SSE2__) && defined(__x86_64__))
+#   define FASTFILE_SSE2
+#   include <emmintrin.h>
+#endif
 
 #include "utility.hpp"
 #include "stream.hpp"
-#include "fstream.hpp"
 #include "zstream.hpp"
+#include "pipestream.hpp"
+#include "parstream.hpp"
+#include "mapfile.hpp"
+#include "zindex.hpp"
 #include "fastfile.hpp"
 
 // Assets
 #include "asset.hpp"
-#include "assets/physpreset.hpp"        /* x01 */
-#include "assets/material.hpp"          /* x04 */
-#include "assets/techset.hpp"           /* x05 */
-#include "assets/image.hpp"             /* x06 */
-#include "assets/localize.hpp"          /* x16 */
-#include "assets/rawfile.hpp"           /* x1F */
-#include "assets/stringtable.hpp"       /* x20 */
+#include "registry.hpp"
+#include "pool.hpp"
+#include "intern.hpp"
 
 #define FASTFILE_CHUNK      0x10000
+#define FASTFILE_PREFIX     12
+
+#ifdef DEBUG
+thread_local bool verboseMuted = false;
+#endif
 
 
 /**
@@ -60,15 +74,19 @@ FastFile::~FastFile(void)
         stream = nullptr;
     }
 
-    if (file != nullptr)
+    if (index != nullptr)
     {
-        // NOTE: We use the Windows/WIN32 implementation not STD. Hence the STD
-        //       namespace prefix is not there.
-        fclose(file);
-        file = nullptr;
+        delete index;
+        index = nullptr;
     }
 
-    if (data != nullptr)
+    if (source != nullptr)
+    {
+        delete source;
+        source = nullptr;
+    }
+
+    for (int i = 0; i < XFILE_BLOCK_COUNT; i++)
     {
         // NOTE: In the origianl implementation data would contain the pointers.
         //       However due to the fact that those pointers are 32-bit wide and
@@ -79,8 +97,9 @@ FastFile::~FastFile(void)
         //       accessing it through the index. This is because there are thus
         //       two arrays. One in the data containing fast file address
         //       pointers. And one in memory containing system/memory pointers.
-        free(data);
-        data = nullptr;
+        blocks[i].arena.Release();
+        blocks[i].data = nullptr;
+        blocks[i].current = nullptr;
     }
 
     // Release all the tag pointers.
@@ -91,19 +110,22 @@ FastFile::~FastFile(void)
         section[id].tags = nullptr;
     }
 
-    // Ensure all the individual assets are released.
+    // The assets are all released with their pool.
+    if (pool != nullptr)
+    {
+        delete pool;
+        pool = nullptr;
+    }
+
+    if (strings != nullptr)
+    {
+        delete strings;
+        strings = nullptr;
+    }
+
     id = SECTION_ID_ASSETS;
     if (section[id].assets != nullptr)
     {
-        for (int i = 0; i < section[id].count; i++)
-        {
-            // The assets array contains assets, these need to be released.
-            if (section[id].assets[i].asset != nullptr)
-            {
-                section[id].assets[i].asset->Release();
-                delete section[id].assets[i].asset;
-            }
-        }
         free(section[id].assets);
         section[id].assets = nullptr;
     }
@@ -115,87 +137,354 @@ FastFile::~FastFile(void)
 void FastFile::Initialize(void)
 {
     // First set all dynamic variables to their default values.
+    source = nullptr;
     stream = nullptr;
-    data = nullptr;
+    index = nullptr;
+    pool = nullptr;
+    strings = nullptr;
+    listing = nullptr;
+    trusted = false;
+    for (int i = 0; i < XFILE_BLOCK_COUNT; i++)
+    {
+        blocks[i].data = nullptr;
+        blocks[i].current = nullptr;
+        blocks[i].size = 0;
+        blocks[i].position = 0;
+        blocks[i].kept = true;
+    }
+    block = &blocks[XFILE_BLOCK_VIRTUAL];
+    depth = 0;
     section[0].count = 0;
     section[0].tags = nullptr;
     section[1].count = 0;
     section[1].assets = nullptr;
 
-    // As last open the file.
-    if (_wfopen_s(&file, path, L"rb"))
-    {
-        throw Exception("Could not open file at path '%ls'.", path);
-    }
-
-    VERBOSE("Loading FastFile '%ls'\n", path);
+    // As last map the file, the whole file is handed to ZLib as one block.
+    source = new MappedFileSource(path);
 }
 
 /**
  * Loads the FastFile from file into memory.
+ * @param flags The LOAD_* flags to use.
  */
-void FastFile::Load(void)
+void FastFile::Load(int flags)
 {
+    VERBOSE("Loading FastFile '%ls'\n", path);
+
     // Ensure the file is valid.
     Validate();
 
-    // Realign to the starting of the encoded part.
-    if (fseek(file, 12, SEEK_SET))
+    // The encoded part is read exactly once from front to back.
+    source->Prefetch(FASTFILE_PREFIX, source->GetSize());
+
+    // Create a ZLib stream over the encoded part, which starts after the prefix.
+    // With a spare core the inflating is done ahead of the parsing, unless an
+    // index is built, which needs the inflate state of ZLib.
+    if ((flags & LOAD_PARALLEL) && !(flags & (LOAD_SERIAL | LOAD_INDEX)))
     {
-        throw Exception("Could not reposition within the file.");
+        stream = (Stream*) new ParallelZLibStream(
+            source->GetData() + FASTFILE_PREFIX,
+            source->GetSize() - FASTFILE_PREFIX
+        );
     }
+    else if ((flags & (LOAD_SERIAL | LOAD_INDEX | LOAD_INFLATER | LOAD_ONESHOT)) ||
+        std::thread::hardware_concurrency() < 2)
+    {
+        int decompressor = DECOMPRESSOR_ZLIB;
+
+        if (!(flags & LOAD_INDEX))
+        {
+            if (flags & LOAD_ONESHOT)
+            {
+                decompressor = DECOMPRESSOR_ONESHOT;
+            }
+            else if (flags & LOAD_INFLATER)
+            {
+                decompressor = DECOMPRESSOR_INFLATER;
+            }
+        }
+
+        ZLibStream *zstream = new ZLibStream(
+            source->GetData() + FASTFILE_PREFIX,
+            source->GetSize() - FASTFILE_PREFIX,
+            decompressor
+        );
 
-    // Create a ZLib stream to use for reading.
-    stream = (Stream*) new ZLibStream(file);
+        if (flags & LOAD_INDEX)
+        {
+            delete index;
+            index = new ZIndex();
+            zstream->SetIndex(index);
+        }
+
+        stream = (Stream*)zstream;
+    }
+    else
+    {
+        stream = (Stream*) new PipelinedZLibStream(
+            source->GetData() + FASTFILE_PREFIX,
+            source->GetSize() - FASTFILE_PREFIX
+        );
+    }
     if (stream == nullptr)
     {
         throw Exception("Could not allocate ZLibStream.");
     }
 
     // Load the fast file data in the correct order.
-    LoadHeader(stream);
+    trusted = ((flags & LOAD_TRUSTED) != 0);
+    LoadHeader(stream, flags);
     LoadTags(stream);
     LoadAssets(stream);
 
     // Clean up
     delete stream;
     stream = nullptr;
+
+    // Store the index next to the fast file.
+    if (flags & LOAD_INDEX)
+    {
+        wchar_t indexPath[MAX_PATH];
+
+        GetIndexPath(indexPath);
+        index->Save(
+            indexPath,
+            source->GetData() + FASTFILE_PREFIX,
+            source->GetSize() - FASTFILE_PREFIX
+        );
+    }
+}
+
+/**
+ * Walks all assets to learn their names and where they are, without keeping
+ * them. One asset per type is parsed into and reused, no Store is done and
+ * nothing is printed. The names stay valid as long as the FastFile.
+ * @param assets Receives the assets in the order of the fast file.
+ * @param flags The LOAD_* flags to use.
+ */
+void FastFile::Scan(std::vector<struct AssetInfo> *assets, int flags)
+{
+    assets->clear();
+    listing = assets;
+#ifdef DEBUG
+    verboseMuted = true;
+#endif
+
+    try
+    {
+        Load(flags);
+    }
+    catch (...)
+    {
+        listing = nullptr;
+#ifdef DEBUG
+        verboseMuted = false;
+#endif
+        throw;
+    }
+
+    listing = nullptr;
+#ifdef DEBUG
+    verboseMuted = false;
+#endif
 }
 
 /**
- * Gets the fast file address.
- * @param group The group to get the address of.
- * @param address The pointer to the data within memory.
- * @return The address within the fast file.
+ * Inflates only the header to learn the size of the data, which is the bulk of
+ * the memory a load takes. Nothing is allocated for the data.
+ * @return The number of bytes of data, of all blocks together.
  */
-address_t FastFile::GetAddress(int group, void *address)
+int FastFile::ProbeDataSize(void)
 {
-    size_t intermediate;
+    int data_s = 0;
 
-    ASSERT(group == 4, "Only group 4 is currently supported. (%i)", group);
+    Validate();
 
-    if (address == nullptr)
+    ZLibStream zstream(
+        source->GetData() + FASTFILE_PREFIX,
+        source->GetSize() - FASTFILE_PREFIX
+    );
+
+    if (zstream.ReadMemory(header, 44) != 44)
     {
-        intermediate = (current - data + 1);
+        throw Exception("Could not read the header.");
     }
-    else
+
+    for (int i = 0; i < XFILE_BLOCK_COUNT; i++)
     {
-        ASSERT(
-            address >= data && (address < (data + header[6])),
-            "Address is not of the fast file. %p not in [%p, %p)",
-                address, data, (data + header[6])
+        ASSERT(header[2 + i] >= 0x00 && header[2 + i] <= 0x0FFFFFC4,
+            "Block size is out of bounds. (%i, 0x%08X)", i, header[2 + i]);
+        data_s += header[2 + i];
+    }
+
+    ASSERT(data_s >= 0x00 && data_s <= 0x0FFFFFC4, "Data size is out of bounds. (0x%08X)", data_s);
+    return data_s;
+}
+
+/**
+ * Calculates the SHA-256 of the whole file, which with the size identifies
+ * it in a manifest of known good files. Those can be loaded with
+ * LOAD_TRUSTED, hence the hash must be one a file can not be crafted to.
+ * @param digest Receives the hash and the size.
+ */
+void FastFile::GetDigest(struct FileDigest *digest)
+{
+    BCRYPT_ALG_HANDLE algorithm = nullptr;
+    BCRYPT_HASH_HANDLE hash = nullptr;
+    NTSTATUS status;
+    size_t offset = 0;
+
+    status = BCryptOpenAlgorithmProvider(&algorithm, BCRYPT_SHA256_ALGORITHM, nullptr, 0);
+    if (BCRYPT_SUCCESS(status))
+    {
+        status = BCryptCreateHash(algorithm, &hash, nullptr, 0, nullptr, 0, 0);
+    }
+
+    // BCrypt takes the length as an unsigned long.
+    while (BCRYPT_SUCCESS(status) && offset < source->GetSize())
+    {
+        size_t length = source->GetSize() - offset;
+        if (length > 0x40000000)
+        {
+            length = 0x40000000;
+        }
+
+        status = BCryptHashData(hash, (PUCHAR)(source->GetData() + offset), (ULONG)length, 0);
+        offset += length;
+    }
+
+    if (BCRYPT_SUCCESS(status))
+    {
+        status = BCryptFinishHash(hash, digest->hash, DIGEST_SIZE, 0);
+    }
+
+    if (hash != nullptr)
+    {
+        BCryptDestroyHash(hash);
+    }
+    if (algorithm != nullptr)
+    {
+        BCryptCloseAlgorithmProvider(algorithm, 0);
+    }
+
+    ASSERT(BCRYPT_SUCCESS(status), "Could not hash the file. (0x%08X)", (unsigned int)status);
+    digest->size = (long long)source->GetSize();
+}
+
+/**
+ * Whether the file is loaded without validation, see LOAD_TRUSTED.
+ */
+bool FastFile::IsTrusted(void)
+{
+    return trusted;
+}
+
+/**
+ * Compares the loaded data and the assets with those of another load, e.g.
+ * a checked and an unchecked load of the same file.
+ * @param other The other loaded fast file.
+ * @return true if both are the same; otherwise, false.
+ */
+bool FastFile::IsIdentical(FastFile *other)
+{
+    if (memcmp(header, other->header, sizeof(header)) != 0 ||
+        GetAssetCount() != other->GetAssetCount())
+    {
+        return false;
+    }
+
+    // Streamed blocks only hold their latest allocation.
+    for (int i = 0; i < XFILE_BLOCK_COUNT; i++)
+    {
+        size_t used = (blocks[i].current - blocks[i].data);
+
+        if (blocks[i].kept != other->blocks[i].kept ||
+            (blocks[i].kept && memcmp(blocks[i].data, other->blocks[i].data, used) != 0))
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < GetAssetCount(); i++)
+    {
+        class Asset *asset = GetAsset(i), *otherAsset = other->GetAsset(i);
+        const char *name, *otherName;
+
+        if (GetAssetType(i) != other->GetAssetType(i) || (asset == nullptr) != (otherAsset == nullptr))
+        {
+            return false;
+        }
+
+        if (asset != nullptr)
+        {
+            name = asset->GetName();
+            otherName = otherAsset->GetName();
+
+            if ((name == nullptr) != (otherName == nullptr) ||
+                (name != nullptr && strcmp(name, otherName) != 0))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Gets the path of the index, which is the path of the fast file with "idx"
+ * appended. E.g. "common.ff" has its index in "common.ffidx".
+ * @param dest The destination of MAX_PATH characters.
+ */
+void FastFile::GetIndexPath(wchar_t *dest)
+{
+    if (wcscpy_s(dest, MAX_PATH, path) || wcscat_s(dest, MAX_PATH, L"idx"))
+    {
+        throw Exception("Index path too long for '%ls'.", path);
+    }
+}
+
+/**
+ * Extracts the serialized data of a single asset, using the index written by
+ * Load(LOAD_INDEX). Only the part of the fast file from the closest index
+ * checkpoint up to the end of the asset is inflated.
+ * @param name The name of the asset.
+ * @param buffer Receives the data, which must be released using free().
+ * @return true if found; otherwise, false.
+ */
+bool FastFile::ExtractAsset(const char *name, Buffer_t *buffer)
+{
+    const struct ZIndexEntry *entry;
+
+    Validate();
+
+    // Read the index once.
+    if (index == nullptr)
+    {
+        wchar_t indexPath[MAX_PATH];
+
+        GetIndexPath(indexPath);
+        index = new ZIndex();
+        index->Load(
+            indexPath,
+            source->GetData() + FASTFILE_PREFIX,
+            source->GetSize() - FASTFILE_PREFIX
         );
+    }
 
-        intermediate = (((char*)address) - data + 1);
+    entry = index->Find(name);
+    if (entry == nullptr)
+    {
+        return false;
     }
 
-    ASSERT(
-        intermediate >= 1 && intermediate <= header[6],
-        "Corrupted pointer requested.  1 <= %i >= %i",
-            intermediate, header[6]
+    index->Extract(
+        source->GetData() + FASTFILE_PREFIX,
+        source->GetSize() - FASTFILE_PREFIX,
+        entry, buffer
     );
 
-    return (address_t)(intermediate | 0x40000000);
+    return true;
 }
 
 /**
@@ -213,33 +502,141 @@ bool FastFile::IsValidAddress(address_t address)
     }
 
     intermediate = (int)(address);
-    group   = ((intermediate >> 28) & 7);
+    group   = ((intermediate >> 28) & 0x0F);
     offset  = ((intermediate >>  0) & 0x0FFFFFFF);
 
-    return (group == 4 && offset > 0 && offset <= header[6]);
+    return (group < XFILE_BLOCK_COUNT && blocks[group].kept &&
+        offset > 0 && offset <= blocks[group].size);
 }
 
 /**
- * Get the address pointer for the fast file address.
- * @param address The fast file address.
+ * Validate a range of a fast file, which must be within a single block. The
+ * end is computed in 64 bits, a large size can not wrap into another block.
+ * @param address The address of the start of the range.
+ * @param size The number of bytes.
+ * @return true if valid; otherwise, false.
  */
-char* FastFile::GetPointer(address_t address)
+bool FastFile::IsValidRange(address_t address, unsigned long long size)
 {
     int group, offset, intermediate;
 
-    ASSERT(address != ADDRESS_MISSING && address != ADDRESS_FOLLOWING,
-        "Invalid address passed. (0x%08X)", address);
+    if (address == ADDRESS_MISSING || address == ADDRESS_FOLLOWING)
+    {
+        return false;
+    }
 
     intermediate = (int)(address);
-    group   = ((intermediate >> 28) & 7);
+    group   = ((intermediate >> 28) & 0x0F);
     offset  = ((intermediate >>  0) & 0x0FFFFFFF);
 
-    ASSERT(group == 4 && offset > 0 && offset <= header[6],
-        "Currently unsupported. (0x%08X)",
-            address
-    );
+    return (group < XFILE_BLOCK_COUNT && blocks[group].kept && offset > 0 &&
+        ((unsigned long long)(offset - 1) + size) <= (unsigned long long)blocks[group].size);
+}
+
+/**
+ * Tells whether an address is of a block which is streamed past, its memory
+ * is gone. See LOAD_SKIP_PHYSICAL.
+ * @param address The address to look up.
+ */
+bool FastFile::IsStreamed(address_t address)
+{
+    int group = (int)((address >> 28) & 0x0F);
+
+    if (address == ADDRESS_MISSING || address == ADDRESS_FOLLOWING)
+    {
+        return false;
+    }
+
+    return (group < XFILE_BLOCK_COUNT && !blocks[group].kept);
+}
+
+/**
+ * Converts an array of addresses to pointers, like GetPointer does for each,
+ * e.g. the cells of a string table. Missing addresses become nullptr. With
+ * SSE2, four addresses of the virtual block are checked and widened at once,
+ * others take the way of GetPointer.
+ * @param addresses The fast file addresses.
+ * @param count The number of addresses.
+ * @param pointers Receives the pointers.
+ */
+template <class Policy>
+void FastFile::TranslateAddresses(const address_t *addresses, int count, char **pointers)
+{
+    int i = 0;
+
+#ifdef FASTFILE_SSE2
+    const struct XBlock *virt = &blocks[XFILE_BLOCK_VIRTUAL];
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi32(0x0FFFFFFF);
+    const __m128i group = _mm_set1_epi32(XFILE_BLOCK_VIRTUAL);
+    const __m128i limit = _mm_set1_epi32(virt->size + 1);
+    const __m128i base = _mm_set1_epi64x((long long)(virt->data - 1));
+
+    for (; virt->kept && (i + 4) <= count; i += 4)
+    {
+        __m128i address = _mm_loadu_si128((const __m128i*)(addresses + i));
+        __m128i offset = _mm_and_si128(address, mask);
+        __m128i missing = _mm_cmpeq_epi32(address, zero);
+
+        // Either missing or of the virtual block and within it.
+        __m128i valid = _mm_cmpeq_epi32(_mm_srli_epi32(address, 28), group);
+        if (Policy::enabled)
+        {
+            valid = _mm_and_si128(valid, _mm_cmpgt_epi32(offset, zero));
+            valid = _mm_and_si128(valid, _mm_cmplt_epi32(offset, limit));
+        }
+        valid = _mm_or_si128(valid, missing);
+
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+        {
+            for (int j = i; j < (i + 4); j++)
+            {
+                pointers[j] = (addresses[j] == ADDRESS_MISSING) ? nullptr : GetPointer<Policy>(addresses[j]);
+            }
+            continue;
+        }
 
-    return (data - 1 + offset);
+        // Widen to pointers, the missing ones to nullptr.
+        __m128i low = _mm_add_epi64(_mm_unpacklo_epi32(offset, zero), base);
+        __m128i high = _mm_add_epi64(_mm_unpackhi_epi32(offset, zero), base);
+        low = _mm_andnot_si128(_mm_unpacklo_epi32(missing, missing), low);
+        high = _mm_andnot_si128(_mm_unpackhi_epi32(missing, missing), high);
+
+        _mm_storeu_si128((__m128i*)(pointers + i), low);
+        _mm_storeu_si128((__m128i*)(pointers + i + 2), high);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        pointers[i] = (addresses[i] == ADDRESS_MISSING) ? nullptr : GetPointer<Policy>(addresses[i]);
+    }
+}
+
+template void FastFile::TranslateAddresses<Checked>(const address_t*, int, char**);
+template void FastFile::TranslateAddresses<Unchecked>(const address_t*, int, char**);
+
+/**
+ * Makes a block the one the next reads go to, until PopBlock.
+ * @param block The XFILE_BLOCK_* block.
+ */
+void FastFile::PushBlock(int block)
+{
+    ASSERT(block >= 0 && block < XFILE_BLOCK_COUNT, "Invalid block. (%i)", block);
+    ASSERT(depth < XFILE_BLOCK_DEPTH, "Blocks nested too deep. (%i)", depth);
+
+    stack[depth++] = (int)(this->block - blocks);
+    this->block = &blocks[block];
+}
+
+/**
+ * Returns to the block before the last PushBlock.
+ */
+void FastFile::PopBlock(void)
+{
+    ASSERT(depth > 0, "More blocks popped than pushed.");
+
+    block = &blocks[stack[--depth]];
 }
 
 /**
@@ -257,9 +654,22 @@ void FastFile::Align(int alignment)
             alignment
     );
 
-    // Determine the difference and realign.
-    diff = (current - data);
-    current = (data + ALIGN(diff, alignment));
+    // Determine the difference within the block and realign.
+    diff = (block->position + (block->current - block->data));
+    block->current = (block->data + (ALIGN(diff, (size_t)alignment) - block->position));
+}
+
+/**
+ * Lets a block which is streamed past reuse its memory, only the position
+ * within the block moves on.
+ */
+void FastFile::Rewind(void)
+{
+    if (!block->kept)
+    {
+        block->position += (int)(block->current - block->data);
+        block->current = block->data;
+    }
 }
 
 /**
@@ -282,16 +692,19 @@ void* FastFile::Alloc(int size, int alignment)
         Align(alignment);
     }
 
+    Rewind();
+
     // Boundaries check is necessary
-    if ((current + size) > (data + header[6]))
+    if ((block->position + (block->current - block->data) + size) > block->size)
     {
         throw Exception("Tried to allocate %i bytes beyond the memory boundary.",
-            (current + size) - (data + header[6]));
+            (int)((block->position + (block->current - block->data) + size) - block->size));
     }
 
     // Allocate and advance the pointer for the next allocation
-    void *ptr = current;
-    current += size;
+    block->arena.Commit((block->current - block->data) + size);
+    void *ptr = block->current;
+    block->current += size;
     return ptr;
 }
 
@@ -320,6 +733,28 @@ void* FastFile::ReadMemory(void *dest, int size)
     return dest;
 }
 
+/**
+ * Reads a small block of bytes, e.g. the header of an asset, without copying
+ * it. The bytes are only valid until the next read, hence anything needed
+ * after that must be copied first.
+ * @param size The number of bytes to read, at most PEEK_SIZE.
+ */
+const void* FastFile::BorrowMemory(int size)
+{
+    const char *bytes;
+
+    ASSERT(
+        size > 0 && size <= PEEK_SIZE,
+        "Invalid parameter(s) passed. (%i)",
+            size
+    );
+
+    bytes = stream->Peek(size);
+    stream->Consume(size);
+
+    return bytes;
+}
+
 /**
  * Reads a block of bytes from the stream into shared memory.
  * @param size The number of bytes to read.
@@ -376,37 +811,71 @@ char* FastFile::ReadString(char *dest, int max)
 }
 
 /**
- * Allocates a string with a maximum number of characters.
- * @param max The maximum number of characters to read.
+ * Reads a string from the stream straight into shared memory. The memory is
+ * only taken once the terminator has been read.
+ * @param max The maximum number of bytes to read, or -1 for no limit but the
+ *            remaining memory.
+ * @param alignment The requested alignment.
  * @return A pointer to the string.
  */
 char* FastFile::ReadSharedString(int max, int alignment)
 {
-    char buffer[256], *dest;
-    int read;
+    char *dest;
+    size_t offset;
+    int limit, remaining, read;
 
     ASSERT(
-        max >= 1 && max <= 256,
-        "Max string size must be in [%i, %i) but %i is used instead.",
-            1, 256, max
+        max == -1 || max >= 1,
+        "Max string size must be -1 or at least %i but %i is used instead.",
+            1, max
     );
 
-    // Read the string
-    read = stream->ReadString(buffer, max);
-    if (read < 1)
+    // -1 is to indicate no alignment is required
+    if (alignment != -1)
     {
-        throw Exception("Could not read string. (%d)", read);
+        Align(alignment);
     }
 
-    // Allocate memory and store the string in it
-    dest = (char*)Alloc(read, alignment);
-    if (dest == nullptr)
+    Rewind();
+
+    // The string may take up to the remaining memory, as far as committed.
+    // A chunk is committed ahead, longer strings are not in fast files.
+    offset = (size_t)(block->current - block->data);
+    remaining = (block->size - block->position) - (int)offset;
+    if (remaining > ARENA_CHUNK)
     {
-        throw Exception("Could not allocate memory for a string.");
+        block->arena.Commit(offset + ARENA_CHUNK);
+    }
+    else if (remaining > 0)
+    {
+        block->arena.Commit(offset + remaining);
     }
 
-    // Copy the string
-    memcpy(dest, buffer, read);
+    limit = remaining;
+    if ((size_t)limit > block->arena.GetCommitted(offset))
+    {
+        limit = (int)block->arena.GetCommitted(offset);
+    }
+    if (max != -1 && max < limit)
+    {
+        limit = max;
+    }
+
+    if (limit < 1)
+    {
+        throw Exception("Tried to read a string beyond the memory boundary.");
+    }
+
+    // Read the string in place
+    dest = block->current;
+    read = stream->ReadString(dest, limit);
+    if (read < 1)
+    {
+        throw Exception("Could not read string. (%d)", read);
+    }
+
+    // Advance the pointer for the next allocation
+    block->current += read;
     return dest;
 }
 
@@ -430,27 +899,57 @@ void* FastFile::AllocSharedMemory(int size, int alignment)
     return dest;
 }
 
+/**
+ * Reads an array when its address says it follows, and replaces the address
+ * by the one the array got.
+ * @param address The address of the array, within the memory.
+ * @param size The number of bytes of the array.
+ * @param alignment The required alignment.
+ * @param block The XFILE_BLOCK_* block the array goes to.
+ * @return The array, or nullptr when it did not follow.
+ */
+template <class Policy>
+void* FastFile::ReadArray(address_t *address, int size, int alignment, int block)
+{
+    void *data;
+
+    if (*address != ADDRESS_FOLLOWING)
+    {
+        return nullptr;
+    }
+
+    CHECK(Policy, size > 0, "Corrupted data. (%i bytes)", size);
+
+    PushBlock(block);
+    data = ReadSharedMemory(size, alignment);
+    *address = GetAddress<Policy>(block, data);
+    PopBlock();
+
+    return data;
+}
+
+template void* FastFile::ReadArray<Checked>(address_t*, int, int, int);
+template void* FastFile::ReadArray<Unchecked>(address_t*, int, int, int);
+
 /**
  * Validates the file is a FastFile by inspecting its header data.
  */
 void FastFile::Validate(void)
 {
-    Stream *stream;
     union
     {
         int header[3];
         short encoding[7];
     };
-    
-    // Create the stream.
-    stream = (Stream*) new FileStream(file);
-    if (stream == nullptr)
+
+    // The prefix and the ZLib header must be present.
+    if (source->GetSize() < (FASTFILE_PREFIX + 2))
     {
-        throw Exception("Could not allocate FileStream.");
+        throw Exception("File is not a Fast File.");
     }
 
     // Load the data into encoding, this is guarenteed to hold the data.
-    stream->ReadMemory(encoding, 14);
+    memcpy(encoding, source->GetData(), 14);
 
     // Verify the version
     if (header[0] != (int)0x66665749 ||
@@ -473,16 +972,14 @@ void FastFile::Validate(void)
         VERBOSE("encoding[6] = 0x%04hX\n", encoding[6]);
         throw Exception("Corrupted Fast File data.");
     }
-
-    // Clean up
-    delete stream;
 }
 
 /**
  * Load the header and fixed values into memory.
  * @param stream The stream to load the data from.
+ * @param flags The LOAD_* flags to use, some of which pick the arena.
  */
-void FastFile::LoadHeader(Stream *stream)
+void FastFile::LoadHeader(Stream *stream, int flags)
 {
     int file_s, data_s;
     struct
@@ -504,13 +1001,33 @@ void FastFile::LoadHeader(Stream *stream)
     ASSERT(file_s >= 0x3C && file_s <= 0x10000000, "File size is out of bounds. (0x%08X)", file_s);
     ASSERT(data_s >= 0x00 && data_s <= 0x0FFFFFC4, "Data size is out of bounds. (0x%08X)", data_s);
 
-    // Allocate the data buffer.
-    data = (char*)calloc(data_s, 1);
-    if (data == nullptr)
+    // Reserve each block, it is committed as it fills. The sizes follow the
+    // file and external size.
+    for (int i = 0; i < XFILE_BLOCK_COUNT; i++)
     {
-        throw Exception("Out of memory (data_s)");
+        struct XBlock *target = &blocks[i];
+        int arenaFlags = ((flags & LOAD_CALLOC) ? ARENA_CALLOC : ARENA_DEFAULT);
+
+        ASSERT(header[2 + i] >= 0x00 && header[2 + i] <= 0x0FFFFFC4,
+            "Block size is out of bounds. (%i, 0x%08X)", i, header[2 + i]);
+
+        // Large pages are committed whole, only the bulk is worth it.
+        if ((flags & LOAD_LARGE_PAGES) && i == XFILE_BLOCK_VIRTUAL)
+        {
+            arenaFlags |= ARENA_LARGE_PAGES;
+        }
+
+        target->size = header[2 + i];
+        target->position = 0;
+        target->kept = !((flags & LOAD_SKIP_PHYSICAL) &&
+            (i == XFILE_BLOCK_PHYSICAL || i == XFILE_BLOCK_VERTEX || i == XFILE_BLOCK_INDEX));
+        target->arena.Create(target->size, arenaFlags);
+        target->data = target->arena.GetData();
+        target->current = target->data;
     }
-    current = data;
+
+    block = &blocks[XFILE_BLOCK_VIRTUAL];
+    depth = 0;
 
     // Set the variables.
     this->section[SECTION_ID_TAGS].count = (
@@ -564,7 +1081,14 @@ void FastFile::LoadTags(Stream *stream)
         section[SECTION_ID_TAGS].count = count;
 
         // Start reading the tags into memory.
-        ReadTags(stream, count, address);
+        if (trusted)
+        {
+            ReadTags<Unchecked>(stream, count, address);
+        }
+        else
+        {
+            ReadTags<Checked>(stream, count, address);
+        }
     }
 }
 
@@ -574,10 +1098,12 @@ void FastFile::LoadTags(Stream *stream)
  * @param count The number of tag entries.
  * @param address The address to data resides at.
  */
+template <class Policy>
 void FastFile::ReadTags(Stream *stream, int count, address_t address)
 {
     int *index;
 
+    UNREFERENCED_PARAMETER(stream);
     UNREFERENCED_PARAMETER(address);
     ASSERT(count > 0 && count == section[SECTION_ID_TAGS].count,
         "Internal error (%i != %lli)",
@@ -589,18 +1115,14 @@ void FastFile::ReadTags(Stream *stream, int count, address_t address)
     Align(4);
 #endif
 
-    // Preserve a pointer into the index.
-    index = (int*)current;
-
     // Copy the index to the data.
-    stream->ReadMemory(current, (count * 4));
-    current += (count * 4);
+    index = (int*)ReadSharedMemory(count * 4);
 
     // Copy the strings and set the variables.
     for (int i = 0; i < count; i++)
     {
         // Could be something else but would be bad optimization.
-        ASSERT(
+        CHECK(Policy,
             index[i] == ADDRESS_MISSING ||
             index[i] == ADDRESS_FOLLOWING,
             "Bad optimization detected. (%i, 0x%08X)",
@@ -614,13 +1136,9 @@ void FastFile::ReadTags(Stream *stream, int count, address_t address)
         }
         else
         {
-            // Set the variables.
-            index[i] = GetAddress(4);
-            section[SECTION_ID_TAGS].tags[i] = current;
-
-            // Copy the string.
-            stream->ReadString(current, -1);
-            current += (strlen(current) + 1);
+            // Set the variables and copy the string.
+            index[i] = GetAddress<Policy>(4);
+            section[SECTION_ID_TAGS].tags[i] = ReadSharedString();
         }
     }
 }
@@ -679,6 +1197,8 @@ void FastFile::ReadAssets(Stream *stream, int count, address_t address)
 {
     int id;
     address_t *index;
+    int counts[ASSET_TYPE_COUNT] = { 0 };
+    class Asset *scanners[ASSET_TYPE_COUNT] = { nullptr };
 
     UNREFERENCED_PARAMETER(address);
     ASSERT(count > 0 && count == section[SECTION_ID_ASSETS].count,
@@ -692,12 +1212,8 @@ void FastFile::ReadAssets(Stream *stream, int count, address_t address)
     // Pointers require four bye alignment.
     Align(4);
 
-    // Preserve a pointer into the index.
-    index = (address_t*)current;
-
     // Copy the index
-    stream->ReadMemory(current, (count * 8));
-    current += (count * 8);
+    index = (address_t*)ReadSharedMemory(count * 8);
 
     // Fill the memory index. (For 64-bit compatibility.)
     for (int i = 0; i < count; i++)
@@ -715,296 +1231,251 @@ void FastFile::ReadAssets(Stream *stream, int count, address_t address)
         // Store the type.
         section[id].assets[i].type = type;
 
-        // Each type requires individual allocation.
-        switch (type)
+        ASSERT(
+            type >= 1 && type < ASSET_TYPE_COUNT,
+            "Invalid asset type. (0x%02X)",
+                type
+        );
+
+        // Count the assets per type, a scan reuses one per type.
+        if (assetTypes[type].create != nullptr)
         {
-        case ASSET_TYPE_PHYSPRESET:
-            section[id].assets[i].asset = (Asset*) new Physpreset();
-            break;
-
-        case ASSET_TYPE_MATERIAL:
-            section[id].assets[i].asset = (Asset*) new Material();
-            break;
-
-        case ASSET_TYPE_TECHSET:
-            section[id].assets[i].asset = (Asset*) new Techset();
-            break;
-
-        case ASSET_TYPE_IMAGE:
-            section[id].assets[i].asset = (Asset*) new Image();
-            break;
-
-        case ASSET_TYPE_LOCALIZE:
-            section[id].assets[i].asset = (Asset*) new Localize();
-            break;
-
-        case ASSET_TYPE_RAWFILE:
-            section[id].assets[i].asset = (Asset*) new Rawfile();
-            break;
-
-        case ASSET_TYPE_STRINGTABLE:
-            section[id].assets[i].asset = (Asset*) new Stringtable();
-            break;
-
-        default:
-            ASSERT(
-                type >= 1 && type <= 0x20,
-                "Invalid asset type. (0x%02X)",
-                    type
-            );
-            section[id].assets[i].asset = nullptr;
-            break;
+            counts[type] = (listing == nullptr) ? (counts[type] + 1) : 1;
         }
     }
 
-    // Load individual assets.
+    // Allocate the assets adjacent by type.
+    pool = new AssetPool();
+    pool->Reserve(counts);
+
     for (int i = 0; i < count; i++)
     {
-        Asset *asset = section[id].assets[i].asset;
+        int type = (int)section[id].assets[i].type;
 
-        if (asset == nullptr)
+        if (listing == nullptr && assetTypes[type].create != nullptr)
         {
-            throw Exception(
-                "Encountered unsupported asset type. (%s / type: %i))",
-                lpAssetType[section[id].assets[i].type],
-                section[id].assets[i].type
-            );
+            section[id].assets[i].asset = pool->Create(type);
         }
+        else
+        {
+            section[id].assets[i].asset = nullptr;
+        }
+    }
 
-        VERBOSE("Parsing asset %i/%i of type %s\n", i+1, count, lpAssetType[section[id].assets[i].type]);
-        asset->Load(this, (index + (i * 2) + 1));
-        VERBOSE("DONE.");
+    // Load individual assets.
+    for (int i = 0; i < count; i++)
+    {
+        LoadAsset(stream, i, (index + (i * 2) + 1), scanners);
+    }
 
-#ifdef DEBUG
+    ASSERT(depth == 0, "Blocks pushed but not popped. (%i)", depth);
 
-#define ASSET_NOT(x) \
-    case (ASSET_TYPE_ ##x): \
-        throw Exception( "" #x " not yet implemented." ); \
-        break
+    // Verify we read exactly, the assets are all in the virtual block.
+    size_t size = blocks[XFILE_BLOCK_VIRTUAL].size;
+    size_t read = (blocks[XFILE_BLOCK_VIRTUAL].current - blocks[XFILE_BLOCK_VIRTUAL].data);
 
-        const int OFFSET = 32;
+    if (read != size)
+    {
+        DumpMemory();
+    }
 
-        switch (section[id].assets[i].type)
-        {
-        case ASSET_TYPE_PHYSPRESET:
-            {
-                class Physpreset *phys = (class Physpreset *)section[id].assets[i].asset;
-                if (phys != nullptr)
-                {
-                    VERBOSE("\nPYSPRESET\n\t%-32s%s\n\t%-32s%s\n\t%-32s%f\n\t%-32s0x%08X\n\t%-32s%i\n\t%-32s%f\n\t%-32s%f\n\t%-32s%f\n\t%-32s%f\n\t%-32s%f\n\t%-32s%i\n",
-                        "name", phys->name,
-                        "sndAliasPrefix", phys->sndAliasPrefix,
-                        "mass", phys->mass,
-                        "friction", phys->friction,
-                        "isFrictionInfinity", phys->isFrictionInfinity,
-                        "bounce", phys->bounce,
-                        "bulletForceScale", phys->bulletForceScale,
-                        "explosiveForceScale", phys->explosiveForceScale,
-                        "piecesSpreadFraction", phys->piecesSpreadFraction,
-                        "piecesUpwardVelocity", phys->piecesUpwardVelocity,
-                        "tempDefaultToCylinder", phys->tempDefaultToCylinder
-                    );
-                }
-            }
-            break;
+    ASSERT(
+        read == size,
+        "NOTICE: Did not read all the data. (0x%08zX != 0x%08zX)\n",
+            size, read
+    );
+}
 
-        case ASSET_TYPE_MATERIAL:
-            {
-                class Material *mat = (class Material *)section[id].assets[i].asset;
-                if (mat != nullptr)
-                {
-                    VERBOSE("\nMATERIAL\n\t%-*s%s\n", OFFSET,
-                        "material->name", mat->name);
-                }
-            }
-            break;
+/**
+ * Gets a script string of the tags section.
+ * @param i The number of the tag.
+ * @return The string, or nullptr when the tag is empty.
+ */
+const char* FastFile::GetTag(int i)
+{
+    ASSERT(
+        i >= 0 && i < section[SECTION_ID_TAGS].count,
+        "Tag out of range. (%i)",
+            i
+    );
 
-        case ASSET_TYPE_TECHSET:
-            {
-                class Techset *set = (class Techset *)section[id].assets[i].asset;
-                if (set != nullptr)
-                {
-                    VERBOSE("\nTECHSET\n\t%-*s%s\n", OFFSET, "techset", set->name);
-
-                    for (int j = 0; j < MAX_TECHNIQUES; j++)
-                    {
-                        address_t *address_p, address;
-                        bool validAddress = false;
-
-                        address = set->techniques[j];
-                        VERBOSE("\t%-32s", lpTechSetName[j]);
-
-                        if (address != ADDRESS_MISSING)
-                        {
-                            if (IsValidAddress(address))
-                            {
-                                address_p = (address_t*)GetPointer(address);
-
-                                if (*address_p != ADDRESS_MISSING)
-                                {
-                                    if (IsValidAddress(*address_p))
-                                    {
-                                        char *techName = GetPointer(*address_p);
-
-                                        if (techName[0] != 0)
-                                        {
-                                            VERBOSE("%s\n", techName);
-                                            validAddress = true;
-                                        }
-                                    }
-                                }
-                                else
-                                {
-                                    validAddress = true;
-                                    VERBOSE("<null>\n");
-                                }
-
-                                if (!validAddress)
-                                {
-                                    VERBOSE("<error>\n");
-                                    validAddress = true; // The other was valid
-                                }
-                            }
-                        }
-                        else
-                        {
-                            validAddress = true;
-                            VERBOSE("<null>\n");
-                        }
-
-                        if (!validAddress)
-                        {
-                            VERBOSE("<error>\n");
-                        }
-                    }
-                }
-            }
-            break;
+    return section[SECTION_ID_TAGS].tags[i];
+}
 
-        case ASSET_TYPE_IMAGE:
-            {
-                class Image *img = (class Image *)section[id].assets[i].asset;
-                if (img != nullptr)
-                {
-                    VERBOSE("\nIMAGE\n\t%-*s%s\n", OFFSET, "image->name", img->name);
-
-                    VERBOSE("\t%-*s%hhu\n", OFFSET, "image->metadata.type", img->metadata.type);
-                    VERBOSE("\t%-*s%hhu\n", OFFSET, "image->metadata.usage", img->metadata.usage);
-
-                    VERBOSE("\t%-*s%hu\n", OFFSET, "image->metadata.width", img->metadata.width);
-                    VERBOSE("\t%-*s%hu\n", OFFSET, "image->metadata.height", img->metadata.height);
-                    VERBOSE("\t%-*s%hu\n", OFFSET, "image->metadata.flags", img->metadata.flags);
-
-                    uint32_t format = img->metadata.format;
-
-                    if (format == 0x31545844 ||
-                        format == 0x33545844 ||
-                        format == 0x35545844)
-                    {
-                        VERBOSE("\t%-*s%.4s\n", OFFSET, "image->metadata.format",
-                            (char*)(&(img->metadata.format)));
-                    }
-                    else
-                    {
-                        VERBOSE("\t%-*s%i\n", OFFSET, "image->metadata.format", img->metadata.format);
-                    }
-                }
-            }
-            break;
+/**
+ * Interns a string of the fast file, see InternTable. The table is shared by
+ * all assets of the file, e.g. to compare names by their pointers.
+ * @param string The string, within the memory.
+ * @return The first equal string interned.
+ */
+const char* FastFile::Intern(const char *string)
+{
+    if (strings == nullptr)
+    {
+        strings = new InternTable();
+    }
 
-        case ASSET_TYPE_LOCALIZE:
-            {
-                class Localize *loc = (class Localize *)section[id].assets[i].asset;
-                if (loc != nullptr)
-                {
-                    VERBOSE("\nLOCALIZE\n\t%s\n\t%s\n",
-                        loc->key, loc->value);
-                }
-            }
-            break;
+    return strings->Intern(string);
+}
 
-        case ASSET_TYPE_RAWFILE:
-            {
-                class Rawfile *raw = (class Rawfile *)section[id].assets[i].asset;
-                if (raw != nullptr)
-                {
-                    VERBOSE("\nRAWFILE\n\t%s (%i)\n\t%s\n",
-                        raw->name, raw->data_s, raw->data);
-                }
-            }
-            break;
+/**
+ * Gets the number of assets loaded.
+ */
+int FastFile::GetAssetCount(void)
+{
+    return (int)section[SECTION_ID_ASSETS].count;
+}
 
-        case ASSET_TYPE_STRINGTABLE:
-            {
-                class Stringtable *table = (class Stringtable *)section[id].assets[i].asset;
-                if (table != nullptr)
-                {
-                    VERBOSE("\nSTRINGTABLE\n");
-
-                    for (int y = 0; y < table->rows; y++)
-                    {
-                        fputc('\t', stderr);
-
-                        for (int x = 0; x < table->columns; x++)
-                        {
-                            int z = ((y * table->columns) + x);
-
-                            if (x == 0)
-                            {
-                                VERBOSE("%s", table->cells[z]);
-                            }
-                            else
-                            {
-                                VERBOSE(",%s", table->cells[z]);
-                            }
-                        }
-
-                        fputc('\n', stderr);
-                    }
-                }
-            }
-            break;
-
-        // Types for future implementation
-        ASSET_NOT( XANIM );
-        ASSET_NOT( XMODEL );
-        ASSET_NOT( SOUND );
-        ASSET_NOT( SNDCURVE );
-        ASSET_NOT( COL_MAP_SP );
-        ASSET_NOT( COL_MAP_MP );
-        ASSET_NOT( COM_MAP );
-        ASSET_NOT( GAME_MAP_SP );
-        ASSET_NOT( GAME_MAP_MP );
-        ASSET_NOT( GFX_MAP );
-        ASSET_NOT( LIGHTDEF );
-        ASSET_NOT( FONT );
-        ASSET_NOT( MENUFILE );
-        ASSET_NOT( WEAPON );
-        ASSET_NOT( SNDDRIVERGLOBALS );
-        ASSET_NOT( FX );
-        ASSET_NOT( IMPACTFX );
-        
-        default:
-            break;
+/**
+ * Gets the ASSET_TYPE_* type of an asset.
+ * @param i The number of the asset.
+ */
+long long int FastFile::GetAssetType(int i)
+{
+    ASSERT(
+        i >= 0 && i < section[SECTION_ID_ASSETS].count,
+        "Asset out of range. (%i)",
+            i
+    );
+
+    return section[SECTION_ID_ASSETS].assets[i].type;
+}
+
+/**
+ * Gets an asset, which is stored on the first access. Assets nobody accesses
+ * never pay for translating their pointers.
+ * @param i The number of the asset.
+ * @return The asset, or nullptr when its type is not supported.
+ */
+class Asset* FastFile::GetAsset(int i)
+{
+    struct AssetEntry *entry;
+
+    ASSERT(
+        i >= 0 && i < section[SECTION_ID_ASSETS].count,
+        "Asset out of range. (%i)",
+            i
+    );
+
+    entry = &section[SECTION_ID_ASSETS].assets[i];
+    if (entry->asset != nullptr && !entry->stored)
+    {
+        entry->asset->Store(this, &entry->handle);
+        entry->stored = true;
+    }
+
+    return entry->asset;
+}
+
+/**
+ * Stores all assets of a type, see GetAssets.
+ * @param type The ASSET_TYPE_* type.
+ * @param size The size of the asset class, which must be that of the type.
+ * @param count Receives the number of assets.
+ * @return The first asset, or nullptr when there are none.
+ */
+class Asset* FastFile::StoreAssets(int type, size_t size, int *count)
+{
+    ASSERT(type >= 0 && type < ASSET_TYPE_COUNT, "Invalid asset type. (0x%02X)", type);
+
+    *count = (pool != nullptr && listing == nullptr) ? pool->GetCount(type) : 0;
+    if (*count == 0)
+    {
+        return nullptr;
+    }
+
+    ASSERT(
+        size == pool->GetStride(type),
+        "Asset class does not match the type. (%s, %zu != %zu)",
+            lpAssetType[type], size, pool->GetStride(type)
+    );
+
+    for (int i = 0; i < section[SECTION_ID_ASSETS].count; i++)
+    {
+        if (section[SECTION_ID_ASSETS].assets[i].type == type)
+        {
+            GetAsset(i);
         }
-        fputc('\n', stderr);
-#endif
     }
 
-    // Verify we read exactly.
-    size_t size = header[6];
-    size_t read = (current - data);
+    return pool->GetAsset(type, 0);
+}
 
-    if (read != size)
+/**
+ * Loads a single asset, or when scanning, only parses it into the
+ * asset of its type and lists it.
+ * @param stream The stream to load the data from.
+ * @param i The number of the asset.
+ * @param handle The handle of the asset in the index.
+ * @param scanners The reused asset per type when scanning.
+ */
+void FastFile::LoadAsset(Stream *stream, int i, address_t *handle, class Asset **scanners)
+{
+    struct AssetEntry *entry = &section[SECTION_ID_ASSETS].assets[i];
+    class Asset *asset = entry->asset;
+    bool followed = (*handle == ADDRESS_FOLLOWING);
+    int start;
+
+    // A scan keeps nothing of the assets, thus one per type does.
+    if (listing != nullptr && assetTypes[entry->type].create != nullptr)
     {
-        DumpMemory();
+        if (scanners[entry->type] == nullptr)
+        {
+            scanners[entry->type] = pool->Create((int)entry->type);
+        }
+        asset = scanners[entry->type];
+    }
+
+    if (asset == nullptr)
+    {
+        throw Exception(
+            "Encountered unsupported asset type. (%s / type: %i))",
+            lpAssetType[entry->type],
+            entry->type
+        );
     }
 
+    start = stream->GetPosition();
+    if (listing != nullptr)
+    {
+        asset->Load(this, handle);
+        listing->push_back({ entry->type, asset->GetName(), start, stream->GetPosition() - start });
+    }
+    else
+    {
+        VERBOSE("Parsing asset %i/%i of type %s\n", i+1, (int)section[SECTION_ID_ASSETS].count, lpAssetType[entry->type]);
+        asset->Load(this, handle);
+        VERBOSE("DONE.");
+
+        // Storing waits for the first access.
+        entry->handle = *handle;
+        entry->stored = false;
+    }
+
+    // The fixed part is read first, anything less and the loader and the
+    // registry disagree on the type.
     ASSERT(
-        read == size,
-        "NOTICE: Did not read all the data. (0x%08zX != 0x%08zX)\n",
-            size, read
+        !followed || (stream->GetPosition() - start) >= assetTypes[entry->type].size,
+        "Asset shorter than its type. (%s, %i of 0x%X bytes)",
+            lpAssetType[entry->type], stream->GetPosition() - start, assetTypes[entry->type].size
     );
+
+    // Keep track of where the asset is within the decompressed data.
+    if (this->index != nullptr)
+    {
+        this->index->AddAsset(
+            (int)entry->type, asset->GetName(),
+            (unsigned int)start, (unsigned int)stream->GetPosition()
+        );
+    }
+
+#ifdef DEBUG
+    if (listing == nullptr)
+    {
+        GetAsset(i)->Dump(this);
+        fputc('\n', stderr);
+    }
+#endif
 }
 
 /**
@@ -1013,18 +1484,22 @@ void FastFile::ReadAssets(Stream *stream, int count, address_t address)
 void FastFile::DumpMemory(void)
 {
 #ifdef DEBUG
+    struct XBlock *dump = &blocks[XFILE_BLOCK_VIRTUAL];
 
     fputs("\n\nMEMORY DUMP\n", stdout);
 
-    // Generate a dump of the data buffer.
-    for (int i = 0; i < header[6]; i++)
+    // What has not been read yet may not be committed yet.
+    dump->arena.Commit(dump->size);
+
+    // Generate a dump of the virtual block, which holds the assets.
+    for (int i = 0; i < dump->size; i++)
     {
         if ((i % 8) == 0)
         {
             fputs("  ", stdout);
         }
 
-        fprintf(stdout, "0x%02hhX ", data[i]);
+        fprintf(stdout, "0x%02hhX ", dump->data[i]);
 
         if ((i % 8) == 7)
         {
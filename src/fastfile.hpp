@@ -2,6 +2,7 @@
 #define FASTFILE_HPP
 
 #include <cstdio>
+#include <vector>
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -10,6 +11,11 @@
 
 #include "utility.hpp"
 #include "stream.hpp"
+#include "mapfile.hpp"
+#include "arena.hpp"
+#include "policy.hpp"
+#include "zindex.hpp"
+#include "buffer.hpp"
 #include "asset.hpp"
 
 #define SECTION_ID_TAGS     0
@@ -18,11 +24,69 @@
 #define ADDRESS_MISSING     (0)
 #define ADDRESS_FOLLOWING   (-1)
 
+#define LOAD_DEFAULT        0x00
+#define LOAD_SERIAL         0x01        /* Inflate on the loading thread. */
+#define LOAD_INDEX          0x02        /* Write a .ffidx index next to the file. */
+#define LOAD_PARALLEL       0x04        /* Inflate on all cores. */
+#define LOAD_INFLATER       0x08        /* Inflate serially with the Inflater. */
+#define LOAD_ONESHOT        0x10        /* Inflate all at once with the Inflater. */
+#define LOAD_CALLOC         0x20        /* Allocate the data zeroed up front, for comparison. */
+#define LOAD_LARGE_PAGES    0x40        /* Put the data in large pages when allowed. */
+#define LOAD_TRUSTED        0x80        /* Skip the validation, the caller verified the file. */
+#define LOAD_SKIP_PHYSICAL  0x100       /* Stream past the GPU blocks instead of keeping them. */
+
+#define DIGEST_SIZE         32          /* SHA-256 */
+
+#define XFILE_BLOCK_TEMP                0
+#define XFILE_BLOCK_RUNTIME             1
+#define XFILE_BLOCK_LARGE_RUNTIME       2
+#define XFILE_BLOCK_PHYSICAL_RUNTIME    3
+#define XFILE_BLOCK_VIRTUAL             4   /* Where the assets are, unless pushed elsewhere. */
+#define XFILE_BLOCK_LARGE               5
+#define XFILE_BLOCK_PHYSICAL            6
+#define XFILE_BLOCK_VERTEX              7
+#define XFILE_BLOCK_INDEX               8
+#define XFILE_BLOCK_COUNT               9
+#define XFILE_BLOCK_DEPTH               16  /* Of nested PushBlock calls. */
+
+
+/**
+ * A block of the zone, with its own memory and addresses. The group bits of an
+ * address select the block. A block which is not kept is streamed past; its
+ * memory only holds the latest allocation.
+ */
+struct XBlock
+{
+    Arena arena;
+    char *data;
+    char *current;
+    int size;                           // From the header
+    int position;                       // Offset of data within the block
+    bool kept;
+};
 
 struct AssetEntry
 {
     long long int type;
     class Asset *asset;
+    address_t handle;                   // Handed to Store on first access
+    bool stored;
+};
+
+/** Identifies a file in a manifest of trusted files, see FastFile::GetDigest. */
+struct FileDigest
+{
+    unsigned char hash[DIGEST_SIZE];    // SHA-256 of the whole file
+    long long size;
+};
+
+/** Where an asset is within the decompressed data, see FastFile::Scan. */
+struct AssetInfo
+{
+    long long int type;
+    const char *name;
+    int offset;
+    int size;
 };
 
 struct Section
@@ -42,42 +106,214 @@ public:
     FastFile(const wchar_t *path);
     ~FastFile(void);
 
-    void Load(void);
+    void Load(int flags = LOAD_DEFAULT);
     void DumpMemory(void);
 
+    // Reads only the header, e.g. to plan the memory of a batch
+    int ProbeDataSize(void);
+
+    // The SHA-256 and size of the file, to look it up in a manifest of trusted files
+    void GetDigest(struct FileDigest *digest);
+    bool IsTrusted(void);
+    bool IsIdentical(FastFile *other);
+
+    // Lists the assets without keeping them
+    void Scan(std::vector<struct AssetInfo> *assets, int flags = LOAD_DEFAULT);
+
+    // Access to the loaded assets, each is stored on first access
+    int GetAssetCount(void);
+    long long int GetAssetType(int i);
+    class Asset* GetAsset(int i);
+
+    template <class T>
+    T* GetAsset(int i)
+    {
+        return dynamic_cast<T*>(GetAsset(i));
+    }
+
+    /**
+     * Gets all assets of a type, adjacent in the order of the fast file. All
+     * of them are stored first.
+     * @param type The ASSET_TYPE_* type, of which T is the asset class.
+     * @param count Receives the number of assets.
+     * @return The array of assets, or nullptr when there are none.
+     */
+    template <class T>
+    T* GetAssets(int type, int *count)
+    {
+        return dynamic_cast<T*>(StoreAssets(type, sizeof(T), count));
+    }
+
+    // Random access through the .ffidx index, without loading the fast file
+    bool ExtractAsset(const char *name, Buffer_t *buffer);
+
+    // The script strings of the tags section, e.g. the names of bones
+    const char* GetTag(int i);
+
+    // The strings of the file, each equal string by a single pointer
+    const char* Intern(const char *string);
+
     // Address and pointer manipulation
     bool IsValidAddress(address_t address);
+    bool IsValidRange(address_t address, unsigned long long size);
+    bool IsStreamed(address_t address);
+
+    template <class Policy = Checked>
     address_t GetAddress(int group, void *address = nullptr);
+
+    template <class Policy = Checked>
     char* GetPointer(address_t address);
 
+    template <class Policy = Checked>
+    void TranslateAddresses(const address_t *addresses, int count, char **pointers);
+
+    template <class Policy = Checked, class T>
+    void GetSpan(address_t address, int count, struct Span<T> *span);
+
+    // Selects the block the next reads go to, used only during asset loading
+    void PushBlock(int block);
+    void PopBlock(void);
+
     // Allocates memory, used only during asset loading
     void* ReadMemory(void *dest, int size);
+    const void* BorrowMemory(int size);
     char* ReadString(char *dest, int max);
     void* ReadSharedMemory(int size, int alignment = -1);
-    char* ReadSharedString(int max, int alignment = -1);
+    char* ReadSharedString(int max = -1, int alignment = -1);
     void* AllocSharedMemory(int size, int alignment = -1);
+
+    template <class Policy = Checked>
+    void* ReadArray(address_t *address, int size, int alignment = -1, int block = XFILE_BLOCK_VIRTUAL);
    
 private:
     void* Alloc(int size, int alignment);
     void Initialize(void);
     void Validate(void);
-    void LoadHeader(Stream *stream);
+    void LoadHeader(Stream *stream, int flags);
     void LoadTags(Stream *stream);
+    template <class Policy>
     void ReadTags(Stream *stream, int count, address_t address);
     void LoadAssets(Stream *stream);
     void ReadAssets(Stream *stream, int count, address_t address);
+    void LoadAsset(Stream *stream, int i, address_t *handle, class Asset **scanners);
     void Align(int alignment);
+    void Rewind(void);
+    void GetIndexPath(wchar_t *dest);
+    class Asset* StoreAssets(int type, size_t size, int *count);
 
 private:
     wchar_t path[MAX_PATH];
-    std::FILE *file;
+    MappedFileSource *source;
     Stream *stream;
+    ZIndex *index;
+    class AssetPool *pool;
+    class InternTable *strings;
+    std::vector<struct AssetInfo> *listing;
+    bool trusted;
 
     // FastFile data
     int header[11];
-    char *data;
-    char *current;
+    struct XBlock blocks[XFILE_BLOCK_COUNT];
+    struct XBlock *block;
+    int stack[XFILE_BLOCK_DEPTH];
+    int depth;
     struct Section section[2];
 };
 
+/**
+ * Gets the fast file address.
+ * @param group The group to get the address of.
+ * @param address The pointer to the data within memory.
+ * @return The address within the fast file.
+ */
+template <class Policy>
+address_t FastFile::GetAddress(int group, void *address)
+{
+    struct XBlock *target;
+    size_t intermediate;
+
+    CHECK(Policy, group >= 0 && group < XFILE_BLOCK_COUNT, "Invalid block. (%i)", group);
+    target = &blocks[group];
+
+    if (address == nullptr)
+    {
+        intermediate = (target->position + (target->current - target->data) + 1);
+    }
+    else
+    {
+        CHECK(Policy,
+            address >= target->data && (address < (target->data + target->size)),
+            "Address is not of block %i. %p not in [%p, %p)",
+                group, address, target->data, (target->data + target->size)
+        );
+
+        intermediate = (target->position + (((char*)address) - target->data) + 1);
+    }
+
+    CHECK(Policy,
+        intermediate >= 1 && intermediate <= target->size,
+        "Corrupted pointer requested.  1 <= %i >= %i",
+            intermediate, target->size
+    );
+
+    return (address_t)(intermediate | ((size_t)group << 28));
+}
+
+/**
+ * Get the address pointer for the fast file address.
+ * @param address The fast file address.
+ */
+template <class Policy>
+char* FastFile::GetPointer(address_t address)
+{
+    int group, offset, intermediate;
+
+    CHECK(Policy, address != ADDRESS_MISSING && address != ADDRESS_FOLLOWING,
+        "Invalid address passed. (0x%08X)", address);
+
+    intermediate = (int)(address);
+    group   = ((intermediate >> 28) & 0x0F);
+    offset  = ((intermediate >>  0) & 0x0FFFFFFF);
+
+    CHECK(Policy, group < XFILE_BLOCK_COUNT && offset > 0 && offset <= blocks[group].size,
+        "Address beyond its block. (0x%08X)",
+            address
+    );
+    CHECK(Policy, blocks[group].kept,
+        "Address of block %i, which is streamed past. (0x%08X)",
+            group, address
+    );
+
+    return (blocks[group].data - 1 + offset);
+}
+
+/**
+ * Gets the array at an address, without copying it. Arrays of blocks which
+ * were streamed past are empty.
+ * @param address The address of the array.
+ * @param count The number of elements.
+ * @param span Receives the array.
+ */
+template <class Policy, class T>
+void FastFile::GetSpan(address_t address, int count, struct Span<T> *span)
+{
+    span->data = nullptr;
+    span->count = 0;
+
+    if (address == ADDRESS_MISSING || count <= 0 || IsStreamed(address))
+    {
+        return;
+    }
+
+    // Both ends must be within the block.
+    CHECK(Policy,
+        IsValidRange(address, (unsigned long long)count * sizeof(T)),
+        "Array beyond its block. (0x%08X, %i)",
+            address, count
+    );
+
+    span->data = (const T*)GetPointer<Policy>(address);
+    span->count = count;
+}
+
 #endif /* FASTFILE_HPP */
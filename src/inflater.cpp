@@ -0,0 +1,637 @@
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include "inflater.hpp"
+
+#define ENTRY_LENGTH(e)     ((e) & 0x1F)
+#define ENTRY_TABLE         0x80        /* Entry refers to a second level table. */
+#define ENTRY_BITS(e)       (((e) >> 8) & 0xF)
+#define ENTRY_VALUE(e)      ((e) >> 16)
+
+#define CODES_BITS          7
+
+static const uint16_t lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t distBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t distExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const uint8_t codesOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/**
+ * Builds a two level decoding table for a canonical Huffman code. The first
+ * level is indexed by the next (bits) bits of input, longer codes continue in
+ * a second level table sized for the longest code sharing the prefix.
+ * @param lens The code length of each symbol.
+ * @param count The number of symbols.
+ * @param table The destination table.
+ * @param bits The number of bits of the first level.
+ * @param strict Whether an incomplete code is an error, even with one code.
+ * @return true if the code is valid; otherwise, false.
+ */
+static bool BuildTable(const uint8_t *lens, int count, uint32_t *table, int bits, bool strict)
+{
+    int counts[16], offsets[16], longest[1 << INFLATE_LITLEN_BITS];
+    uint16_t sorted[288], reversed[288];
+    int left, max, code, next, used;
+
+    std::memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < count; i++)
+    {
+        counts[lens[i]]++;
+    }
+    counts[0] = 0;
+
+    // Over-subscribed codes are never valid, incomplete ones only as ZLib does.
+    left = 1;
+    max = 0;
+    for (int len = 1; len < 16; len++)
+    {
+        left <<= 1;
+        left -= counts[len];
+        if (left < 0)
+        {
+            return false;
+        }
+        if (counts[len] != 0)
+        {
+            max = len;
+        }
+    }
+    if (left > 0 && (strict || max != 1) && max != 0)
+    {
+        return false;
+    }
+
+    // Sort the symbols by code, the canonical order.
+    used = 0;
+    offsets[1] = 0;
+    for (int len = 1; len < 15; len++)
+    {
+        offsets[len + 1] = offsets[len] + counts[len];
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (lens[i] != 0)
+        {
+            sorted[offsets[lens[i]]++] = (uint16_t)i;
+            used++;
+        }
+    }
+
+    // Assign the codes, reversed as deflate stores them from the first bit on.
+    std::memset(longest, 0, sizeof(int) << bits);
+    code = 0;
+    for (int i = 0, len = 0; i < used; i++)
+    {
+        int sym = sorted[i], rev = 0;
+
+        if (lens[sym] != len)
+        {
+            code <<= (lens[sym] - len);
+            len = lens[sym];
+        }
+
+        for (int b = 0; b < len; b++)
+        {
+            rev |= ((code >> b) & 1) << (len - 1 - b);
+        }
+        reversed[i] = (uint16_t)rev;
+        code++;
+
+        if (len > bits && longest[rev & ((1 << bits) - 1)] < len)
+        {
+            longest[rev & ((1 << bits) - 1)] = len;
+        }
+    }
+
+    std::memset(table, 0, sizeof(uint32_t) << bits);
+    next = (1 << bits);
+    for (int i = 0; i < used; i++)
+    {
+        int sym = sorted[i], len = lens[sym], rev = reversed[i];
+
+        if (len <= bits)
+        {
+            for (int k = rev; k < (1 << bits); k += (1 << len))
+            {
+                table[k] = ((uint32_t)sym << 16) | (uint32_t)len;
+            }
+        }
+        else
+        {
+            uint32_t *entry = &table[rev & ((1 << bits) - 1)];
+            int sub;
+
+            if (*entry == 0)
+            {
+                sub = longest[rev & ((1 << bits) - 1)] - bits;
+                std::memset(&table[next], 0, sizeof(uint32_t) << sub);
+                *entry = ((uint32_t)next << 16) | ((uint32_t)sub << 8) | ENTRY_TABLE;
+                next += (1 << sub);
+            }
+
+            sub = ENTRY_BITS(*entry);
+            for (int k = (rev >> bits); k < (1 << sub); k += (1 << (len - bits)))
+            {
+                table[ENTRY_VALUE(*entry) + k] = ((uint32_t)sym << 16) | (uint32_t)len;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Creates the inflater, positioned at the first bit of input.
+ * @param input The raw deflate data, must outlive the inflater.
+ * @param size The number of bytes of deflate data.
+ */
+Inflater::Inflater(const void *input, size_t size)
+{
+    start = (const uint8_t*)input;
+    end = start + size;
+    type = -1;
+    final = false;
+
+    Seek(0);
+}
+
+Inflater::~Inflater(void)
+{
+    // Nothing to release.
+}
+
+/**
+ * Moves to a bit offset of the input, which should be the start of a block.
+ * @param bit The offset in bits.
+ */
+void Inflater::Seek(size_t bit)
+{
+    size_t bytes = (bit >> 3);
+
+    next = start + ((bytes < (size_t)(end - start)) ? bytes : (size_t)(end - start));
+    bitbuf = 0;
+    bitcount = 0;
+    padding = 0;
+
+    Refill();
+    Bits((int)(bit & 7));
+}
+
+/**
+ * Gets the bit offset of the input which is read next.
+ */
+size_t Inflater::Tell(void)
+{
+    return ((size_t)(next - start) << 3) + padding - (size_t)bitcount;
+}
+
+/**
+ * Fills the bit buffer to at least 56 bits. Past the end of input zeroes are
+ * read, which is detected by the callers through Tell().
+ */
+void Inflater::Refill(void)
+{
+    if ((end - next) >= 8)
+    {
+        uint64_t word;
+
+        // Bits above bitcount hold the same input again, hence the OR.
+        std::memcpy(&word, next, sizeof(uint64_t));
+        bitbuf |= (word << bitcount);
+        next += ((63 - bitcount) >> 3);
+        bitcount |= 56;
+        return;
+    }
+
+    while (bitcount <= 56)
+    {
+        if (next < end)
+        {
+            bitbuf |= ((uint64_t)*next++ << bitcount);
+        }
+        else
+        {
+            padding += 8;
+        }
+        bitcount += 8;
+    }
+}
+
+/**
+ * Reads up to 32 bits of input.
+ * @param count The number of bits.
+ */
+uint32_t Inflater::Bits(int count)
+{
+    uint32_t value;
+
+    if (bitcount < count)
+    {
+        Refill();
+    }
+
+    value = (uint32_t)(bitbuf & ((1ull << count) - 1));
+    bitbuf >>= count;
+    bitcount -= count;
+
+    return value;
+}
+
+/**
+ * Reads the header of the next block, including its Huffman tables.
+ * @return INFLATE_OK or INFLATE_ERROR.
+ */
+int Inflater::ReadHeader(void)
+{
+    uint32_t length, check;
+
+    final = (Bits(1) != 0);
+    type = (int)Bits(2);
+
+    switch (type)
+    {
+        /* Stored */
+        case 0:
+        {
+            Bits((int)((8 - (Tell() & 7)) & 7));
+            length = Bits(16);
+            check = Bits(16);
+            if ((length ^ 0xFFFF) != check)
+            {
+                return INFLATE_ERROR;
+            }
+
+            // The data is copied straight from the input by Copy().
+            stored = length;
+            break;
+        }
+
+        /* Fixed Huffman codes */
+        case 1:
+        {
+            uint8_t lens[288];
+
+            std::memset(lens, 8, 144);
+            std::memset(lens + 144, 9, 112);
+            std::memset(lens + 256, 7, 24);
+            std::memset(lens + 280, 8, 8);
+            BuildTable(lens, 288, litlen, INFLATE_LITLEN_BITS, false);
+
+            // Distance codes 30 and 31 exist, but are rejected when decoding.
+            std::memset(lens, 5, 32);
+            BuildTable(lens, 32, dist, INFLATE_DIST_BITS, false);
+            break;
+        }
+
+        /* Dynamic Huffman codes */
+        case 2:
+        {
+            if (ReadTables() != INFLATE_OK)
+            {
+                return INFLATE_ERROR;
+            }
+            break;
+        }
+
+        default:
+        {
+            return INFLATE_ERROR;
+        }
+    }
+
+    return (Tell() <= ((size_t)(end - start) << 3)) ? INFLATE_OK : INFLATE_ERROR;
+}
+
+/**
+ * Reads the Huffman tables of a dynamic block.
+ * @return INFLATE_OK or INFLATE_ERROR.
+ */
+int Inflater::ReadTables(void)
+{
+    uint32_t codes[1 << CODES_BITS];
+    uint8_t lens[320], codeLens[19];
+    int hlit, hdist, hclen, total;
+
+    hlit = (int)Bits(5) + 257;
+    hdist = (int)Bits(5) + 1;
+    hclen = (int)Bits(4) + 4;
+    if (hlit > 286 || hdist > 30)
+    {
+        return INFLATE_ERROR;
+    }
+
+    std::memset(codeLens, 0, sizeof(codeLens));
+    for (int i = 0; i < hclen; i++)
+    {
+        codeLens[codesOrder[i]] = (uint8_t)Bits(3);
+    }
+    if (!BuildTable(codeLens, 19, codes, CODES_BITS, true))
+    {
+        return INFLATE_ERROR;
+    }
+
+    total = hlit + hdist;
+    for (int i = 0; i < total; )
+    {
+        uint32_t entry;
+        int repeat;
+        uint8_t value;
+
+        if (bitcount < 16)
+        {
+            Refill();
+        }
+
+        entry = codes[bitbuf & ((1 << CODES_BITS) - 1)];
+        if (ENTRY_LENGTH(entry) == 0)
+        {
+            return INFLATE_ERROR;
+        }
+        bitbuf >>= ENTRY_LENGTH(entry);
+        bitcount -= (int)ENTRY_LENGTH(entry);
+
+        switch (ENTRY_VALUE(entry))
+        {
+            case 16:
+            {
+                if (i == 0)
+                {
+                    return INFLATE_ERROR;
+                }
+                value = lens[i - 1];
+                repeat = 3 + (int)Bits(2);
+                break;
+            }
+            case 17:
+            {
+                value = 0;
+                repeat = 3 + (int)Bits(3);
+                break;
+            }
+            case 18:
+            {
+                value = 0;
+                repeat = 11 + (int)Bits(7);
+                break;
+            }
+            default:
+            {
+                value = (uint8_t)ENTRY_VALUE(entry);
+                repeat = 1;
+                break;
+            }
+        }
+
+        if ((i + repeat) > total)
+        {
+            return INFLATE_ERROR;
+        }
+        std::memset(lens + i, value, repeat);
+        i += repeat;
+    }
+
+    // A block without end of block code can not be right.
+    if (lens[256] == 0)
+    {
+        return INFLATE_ERROR;
+    }
+
+    if (!BuildTable(lens, hlit, litlen, INFLATE_LITLEN_BITS, false) ||
+        !BuildTable(lens + hlit, hdist, dist, INFLATE_DIST_BITS, false))
+    {
+        return INFLATE_ERROR;
+    }
+
+    return INFLATE_OK;
+}
+
+/**
+ * Whether the block read last is the final block.
+ */
+bool Inflater::IsFinal(void)
+{
+    return final;
+}
+
+/**
+ * Reads the data of the block of which the header was read last.
+ * @param output The output to append the data to.
+ * @return INFLATE_OK, INFLATE_END after the final block, or INFLATE_ERROR.
+ */
+int Inflater::ReadBlock(InflateOutput<uint8_t> *output)
+{
+    int result = (type == 0) ? Copy(output) : Decode(output);
+
+    if (result != INFLATE_OK)
+    {
+        return result;
+    }
+    return final ? INFLATE_END : INFLATE_OK;
+}
+
+/**
+ * Reads the data of the block of which the header was read last, into wide
+ * output which may refer to the unknown window.
+ * @param output The output to append the data to.
+ * @return INFLATE_OK, INFLATE_END after the final block, or INFLATE_ERROR.
+ */
+int Inflater::ReadBlock(InflateOutput<uint16_t> *output)
+{
+    int result = (type == 0) ? Copy(output) : Decode(output);
+
+    if (result != INFLATE_OK)
+    {
+        return result;
+    }
+    return final ? INFLATE_END : INFLATE_OK;
+}
+
+/**
+ * Checks whether a dynamic block header can start at an offset, used to find
+ * block boundaries. Stored and fixed blocks are too weak a signal to search.
+ * @param bit The offset in bits.
+ * @return true if the header is valid; otherwise, false.
+ */
+bool Inflater::Probe(size_t bit)
+{
+    uint32_t bits;
+
+    Seek(bit);
+
+    // Rule out most offsets before building any table; the block type must be
+    // dynamic and HLIT and HDIST within range.
+    bits = (uint32_t)(bitbuf >> 1);
+    if ((bits & 3) != 2 || ((bits >> 2) & 0x1F) > 29 || ((bits >> 7) & 0x1F) > 29)
+    {
+        return false;
+    }
+
+    return (ReadHeader() == INFLATE_OK && type == 2);
+}
+
+/**
+ * Copies the data of a stored block.
+ */
+template <typename T>
+int Inflater::Copy(InflateOutput<T> *output)
+{
+    size_t length = stored, offset = (Tell() >> 3);
+
+    if (offset + length > (size_t)(end - start))
+    {
+        return INFLATE_ERROR;
+    }
+
+    if (output->data.size() < output->size + length)
+    {
+        output->data.resize((output->size + length) * 2);
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        output->data[output->size + i] = (T)start[offset + i];
+    }
+    output->size += length;
+
+    Seek((offset + length) << 3);
+    return INFLATE_OK;
+}
+
+/**
+ * Decodes the data of a Huffman coded block.
+ */
+template <typename T>
+int Inflater::Decode(InflateOutput<T> *output)
+{
+    size_t pos = output->size, capacity = output->data.size(), marker = output->marker;
+    T *out = output->data.data();
+    uint32_t entry, sym;
+    size_t length, distance;
+
+    for (;;)
+    {
+        // One match takes at most 48 bits, a refill gives at least 56.
+        if ((end - next) >= 8)
+        {
+            uint64_t word;
+
+            std::memcpy(&word, next, sizeof(uint64_t));
+            bitbuf |= (word << bitcount);
+            next += ((63 - bitcount) >> 3);
+            bitcount |= 56;
+        }
+        else
+        {
+            Refill();
+            if (Tell() > ((size_t)(end - start) << 3))
+            {
+                return INFLATE_ERROR;
+            }
+        }
+
+        if (capacity - pos < 258)
+        {
+            output->data.resize((capacity < 0x10000) ? 0x20000 : (capacity * 2));
+            capacity = output->data.size();
+            out = output->data.data();
+        }
+
+        entry = litlen[bitbuf & ((1 << INFLATE_LITLEN_BITS) - 1)];
+        if (entry & ENTRY_TABLE)
+        {
+            entry = litlen[ENTRY_VALUE(entry) +
+                ((bitbuf >> INFLATE_LITLEN_BITS) & ((1u << ENTRY_BITS(entry)) - 1))];
+        }
+        if (ENTRY_LENGTH(entry) == 0)
+        {
+            return INFLATE_ERROR;
+        }
+        bitbuf >>= ENTRY_LENGTH(entry);
+        bitcount -= (int)ENTRY_LENGTH(entry);
+        sym = ENTRY_VALUE(entry);
+
+        /* Literal */
+        if (sym < 256)
+        {
+            out[pos++] = (T)sym;
+            continue;
+        }
+
+        /* End of block */
+        if (sym == 256)
+        {
+            break;
+        }
+
+        /* Match */
+        sym -= 257;
+        if (sym >= 29)
+        {
+            return INFLATE_ERROR;
+        }
+        length = lengthBase[sym] + (size_t)(bitbuf & ((1u << lengthExtra[sym]) - 1));
+        bitbuf >>= lengthExtra[sym];
+        bitcount -= lengthExtra[sym];
+
+        entry = dist[bitbuf & ((1 << INFLATE_DIST_BITS) - 1)];
+        if (entry & ENTRY_TABLE)
+        {
+            entry = dist[ENTRY_VALUE(entry) +
+                ((bitbuf >> INFLATE_DIST_BITS) & ((1u << ENTRY_BITS(entry)) - 1))];
+        }
+        if (ENTRY_LENGTH(entry) == 0 || ENTRY_VALUE(entry) >= 30)
+        {
+            return INFLATE_ERROR;
+        }
+        bitbuf >>= ENTRY_LENGTH(entry);
+        bitcount -= (int)ENTRY_LENGTH(entry);
+        sym = ENTRY_VALUE(entry);
+
+        distance = distBase[sym] + (size_t)(bitbuf & ((1u << distExtra[sym]) - 1));
+        bitbuf >>= distExtra[sym];
+        bitcount -= distExtra[sym];
+
+        if (distance > pos)
+        {
+            return INFLATE_ERROR;
+        }
+
+        // Copies may overlap themselves, which repeats the last bytes.
+        if (sizeof(T) == 1 && distance >= length)
+        {
+            std::memcpy(out + pos, out + pos - distance, length * sizeof(T));
+        }
+        else
+        {
+            const T *from = out + pos - distance;
+
+            for (size_t i = 0; i < length; i++)
+            {
+                out[pos + i] = from[i];
+                if (sizeof(T) != 1 && from[i] >= INFLATE_MARKER)
+                {
+                    marker = pos + i + 1;
+                }
+            }
+        }
+        pos += length;
+    }
+
+    output->size = pos;
+    output->marker = marker;
+    return INFLATE_OK;
+}
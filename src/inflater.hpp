@@ -0,0 +1,77 @@
+#ifndef INFLATER_HPP
+#define INFLATER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define INFLATE_OK              0
+#define INFLATE_END             1           /* The final block has been read. */
+#define INFLATE_ERROR           (-1)
+
+#define INFLATE_WINDOW          32768
+#define INFLATE_MARKER          256         /* Wide symbols from here on refer to the unknown window. */
+
+#define INFLATE_LITLEN_BITS     10
+#define INFLATE_DIST_BITS       8
+#define INFLATE_LITLEN_SIZE     ((1 << INFLATE_LITLEN_BITS) + (286 * 32))
+#define INFLATE_DIST_SIZE       ((1 << INFLATE_DIST_BITS) + (30 * 128))
+
+/**
+ * Output of the inflater. Narrow output holds plain bytes. Wide output holds
+ * 16-bit symbols; values from INFLATE_MARKER on stand for a byte of the
+ * window before the first block, which was not known while inflating.
+ */
+template <typename T>
+struct InflateOutput
+{
+    std::vector<T> data;
+    size_t size;                            // Symbols in use, including history
+    size_t history;                         // Leading symbols which are not output
+    size_t marker;                          // Position past the last marker symbol
+};
+
+/**
+ * Block level deflate decoder (RFC 1951) over a block of memory. Unlike ZLib
+ * it can start at any bit offset, report block boundaries, and inflate with
+ * an unknown window, which the speculative parallel decoding relies on.
+ */
+class Inflater
+{
+public:
+    Inflater(const void *input, size_t size);
+    ~Inflater(void);
+
+    void Seek(size_t bit);
+    size_t Tell(void);
+
+    int ReadHeader(void);
+    bool IsFinal(void);
+    int ReadBlock(InflateOutput<uint8_t> *output);
+    int ReadBlock(InflateOutput<uint16_t> *output);
+
+    bool Probe(size_t bit);
+
+private:
+    template <typename T> int Decode(InflateOutput<T> *output);
+    template <typename T> int Copy(InflateOutput<T> *output);
+    int ReadTables(void);
+    void Refill(void);
+    uint32_t Bits(int count);
+
+private:
+    const uint8_t *start;
+    const uint8_t *end;
+    const uint8_t *next;
+    uint64_t bitbuf;
+    int bitcount;
+    size_t padding;
+
+    int type;
+    bool final;
+    size_t stored;
+    uint32_t litlen[INFLATE_LITLEN_SIZE];
+    uint32_t dist[INFLATE_DIST_SIZE];
+};
+
+#endif /* INFLATER_HPP */
@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <cstring>
+#include "utility.hpp"
+#include "intern.hpp"
+
+InternTable::InternTable(void)
+{
+    entries = nullptr;
+    capacity = 0;
+    count = 0;
+}
+
+InternTable::~InternTable(void)
+{
+    Release();
+}
+
+void InternTable::Release(void) noexcept
+{
+    if (entries != nullptr)
+    {
+        free(entries);
+        entries = nullptr;
+    }
+
+    capacity = 0;
+    count = 0;
+}
+
+/**
+ * Hashes a string by djb2, see docs/djb2.c.
+ */
+static unsigned int Hash(const char *string)
+{
+    unsigned int hash = 0;
+
+    while (*string != 0)
+    {
+        hash = ((hash * 33) ^ (unsigned char)*string++);
+    }
+
+    return hash;
+}
+
+/**
+ * Gets the string equal to the given one which was interned first, or
+ * interns the given one.
+ * @param string The string, which must outlive the table.
+ * @return The interned string, or nullptr for nullptr.
+ */
+const char* InternTable::Intern(const char *string)
+{
+    unsigned int hash, slot;
+
+    if (string == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Keep at least a quarter of the slots free.
+    if (((count + 1) * 4) > (capacity * 3))
+    {
+        Grow();
+    }
+
+    hash = Hash(string);
+    for (slot = (hash & (capacity - 1)); entries[slot].string != nullptr; slot = ((slot + 1) & (capacity - 1)))
+    {
+        if (entries[slot].hash == hash && strcmp(entries[slot].string, string) == 0)
+        {
+            return entries[slot].string;
+        }
+    }
+
+    entries[slot] = { hash, string };
+    count++;
+
+    return string;
+}
+
+/**
+ * Gets the number of distinct strings.
+ */
+int InternTable::GetCount(void)
+{
+    return count;
+}
+
+/**
+ * Doubles the slots, placing each string anew.
+ */
+void InternTable::Grow(void)
+{
+    struct InternEntry *previous = entries;
+    int slots = capacity;
+    unsigned int slot;
+
+    capacity = (capacity == 0) ? INTERN_CAPACITY : (capacity * 2);
+    entries = (struct InternEntry*)calloc(capacity, sizeof(struct InternEntry));
+    if (entries == nullptr)
+    {
+        entries = previous;
+        capacity = slots;
+        throw Exception("Out of memory (intern table)");
+    }
+
+    for (int i = 0; i < slots; i++)
+    {
+        if (previous[i].string != nullptr)
+        {
+            slot = (previous[i].hash & (capacity - 1));
+            while (entries[slot].string != nullptr)
+            {
+                slot = ((slot + 1) & (capacity - 1));
+            }
+            entries[slot] = previous[i];
+        }
+    }
+
+    free(previous);
+}
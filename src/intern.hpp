@@ -0,0 +1,38 @@
+#ifndef INTERN_HPP
+#define INTERN_HPP
+
+#include "utility.hpp"
+
+#define INTERN_CAPACITY     256         /* Slots of a new table, a power of two. */
+
+struct InternEntry
+{
+    unsigned int hash;
+    const char *string;
+};
+
+/**
+ * The distinct strings of a fast file. The first of equal strings stands for
+ * all of them, hence equal strings have equal pointers once interned. The
+ * strings are not copied, they stay where they are in the fast file.
+ */
+class InternTable
+{
+public:
+    InternTable(void);
+    ~InternTable(void);
+    void Release(void) noexcept;
+
+    const char* Intern(const char *string);
+    int GetCount(void);
+
+private:
+    void Grow(void);
+
+private:
+    struct InternEntry *entries;
+    int capacity;
+    int count;
+};
+
+#endif /* INTERN_HPP */
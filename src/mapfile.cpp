@@ -0,0 +1,122 @@
+#include "utility.hpp"
+#include "mapfile.hpp"
+
+/**
+ * Maps a file read-only into the address space of the process.
+ * @param path The UNICODE path of the file.
+ */
+MappedFileSource::MappedFileSource(const wchar_t *path)
+{
+    LARGE_INTEGER length;
+
+    file = INVALID_HANDLE_VALUE;
+    mapping = nullptr;
+    data = nullptr;
+    size = 0;
+
+    // The file is read front to back exactly once, let the cache manager know.
+    file = CreateFileW(
+        path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw Exception("Could not open file at path '%ls'.", path);
+    }
+
+    if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0)
+    {
+        Release();
+        throw Exception("Could not determine the size of '%ls'.", path);
+    }
+
+    // Map the complete file, a mapping of an empty file is not possible.
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Release();
+        throw Exception("Could not create a file mapping for '%ls'.", path);
+    }
+
+    data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        Release();
+        throw Exception("Could not map a view of '%ls'.", path);
+    }
+
+    size = (size_t)length.QuadPart;
+}
+
+/**
+ * Unmaps the file and releases the handles.
+ */
+MappedFileSource::~MappedFileSource(void)
+{
+    Release();
+}
+
+void MappedFileSource::Release(void) noexcept
+{
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+        data = nullptr;
+    }
+
+    if (mapping != nullptr)
+    {
+        CloseHandle(mapping);
+        mapping = nullptr;
+    }
+
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+
+    size = 0;
+}
+
+/**
+ * Gets a pointer to the first byte of the mapped file.
+ */
+const char* MappedFileSource::GetData(void)
+{
+    return data;
+}
+
+/**
+ * Gets the size of the mapped file in bytes.
+ */
+size_t MappedFileSource::GetSize(void)
+{
+    return size;
+}
+
+/**
+ * Asks the memory manager to page in a range of the file ahead of use.
+ * @param offset The offset of the range within the file.
+ * @param size The number of bytes in the range.
+ */
+void MappedFileSource::Prefetch(size_t offset, size_t size)
+{
+    WIN32_MEMORY_RANGE_ENTRY range;
+
+    if (offset >= this->size)
+    {
+        return;
+    }
+
+    if (size > (this->size - offset))
+    {
+        size = (this->size - offset);
+    }
+
+    range.VirtualAddress = (PVOID)(data + offset);
+    range.NumberOfBytes = size;
+
+    // NOTE: Only a hint, failure merely means the pages are faulted in on use.
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
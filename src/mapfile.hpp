@@ -0,0 +1,26 @@
+#ifndef MAPFILE_HPP
+#define MAPFILE_HPP
+
+#include "utility.hpp"
+
+class MappedFileSource
+{
+public:
+    MappedFileSource(const wchar_t *path);
+    ~MappedFileSource(void);
+
+    const char* GetData(void);
+    size_t GetSize(void);
+    void Prefetch(size_t offset, size_t size);
+
+private:
+    void Release(void) noexcept;
+
+private:
+    HANDLE file;
+    HANDLE mapping;
+    const char *data;
+    size_t size;
+};
+
+#endif /* MAPFILE_HPP */
@@ -0,0 +1,554 @@
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
+#include "stream.hpp"
+#include "zstream.hpp"
+#include "inflater.hpp"
+#include "parstream.hpp"
+
+/**
+ * Creates the stream and starts inflating the input on all cores.
+ * @param input The deflated data, starting at the ZLib header. It must
+ *              outlive the stream.
+ * @param size The number of bytes of deflated data.
+ */
+ParallelZLibStream::ParallelZLibStream(const void *input, size_t size) :
+    Stream(nullptr), claimed(0), needed(0), stop(false)
+{
+    const uint8_t *header = (const uint8_t*)input;
+    size_t threads;
+
+    // ZLib header; deflate, no preset dictionary.
+    if (size < 6 || (header[0] & 0x0F) != 8 || (header[1] & 0x20) != 0 ||
+        ((header[0] << 8) | header[1]) % 31 != 0)
+    {
+        throw std::exception("Invalid ZLib header.\n");
+    }
+
+    this->input = header + 2;
+    this->size = size - 2;
+    current = 0;
+    held = PARALLEL_NONE;
+    position = 0;
+    continuing = false;
+    finished = false;
+    serial = nullptr;
+    piece = 0;
+    adler = adler32(0L, Z_NULL, 0);
+    std::memset(history, 0, INFLATE_WINDOW);
+
+    count = (this->size + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    chunks = new (std::nothrow) ParallelChunk[count];
+    if (chunks == nullptr)
+    {
+        throw std::exception("Could not allocate parallel chunks.\n");
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        chunks[i].begin = ((i * PARALLEL_CHUNK_SIZE) << 3);
+        chunks[i].start = PARALLEL_NONE;
+        chunks[i].stop = PARALLEL_NONE;
+        chunks[i].status = INFLATE_ERROR;
+        chunks[i].wide.size = 0;
+        chunks[i].wide.history = 0;
+        chunks[i].wide.marker = 0;
+        chunks[i].narrow.size = 0;
+        chunks[i].narrow.history = 0;
+        chunks[i].narrow.marker = 0;
+        chunks[i].done.store(false, std::memory_order_relaxed);
+    }
+
+    threads = std::thread::hardware_concurrency();
+    threads = (threads < 1) ? 1 : ((threads > count) ? count : threads);
+    ahead = (threads * PARALLEL_AHEAD);
+
+    try
+    {
+        for (size_t i = 0; i < threads; i++)
+        {
+            workers.push_back(std::thread(&ParallelZLibStream::Work, this));
+        }
+    }
+    catch (...)
+    {
+        stop.store(true, std::memory_order_relaxed);
+        Signal();
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+        delete[] chunks;
+        throw;
+    }
+}
+
+/**
+ * Stops the workers, which may still be inflating ahead, and releases all.
+ */
+ParallelZLibStream::~ParallelZLibStream(void)
+{
+    stop.store(true, std::memory_order_relaxed);
+    Signal();
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        if (workers[i].joinable())
+        {
+            workers[i].join();
+        }
+    }
+
+    delete[] chunks;
+    delete serial;
+}
+
+/**
+ * Wakes the workers and the reader after needed, a chunk or the stop flag
+ * changed. Taking the lock orders the change before a waiter checking it
+ * under the lock, hence the wake up cannot be lost.
+ */
+void ParallelZLibStream::Signal(void)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+    }
+    changed.notify_all();
+}
+
+/**
+ * Worker thread; takes chunks in order, but no further ahead of the reader
+ * than PARALLEL_AHEAD chunks per thread.
+ */
+void ParallelZLibStream::Work(void)
+{
+    size_t id, limit;
+
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        id = claimed.load(std::memory_order_relaxed);
+        if (id >= count)
+        {
+            return;
+        }
+
+        // Wait for the reader to need chunks further on.
+        limit = needed.load(std::memory_order_acquire) + ahead;
+        if (id >= limit)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [this, id]
+            {
+                return stop.load(std::memory_order_relaxed) ||
+                    id < needed.load(std::memory_order_acquire) + ahead;
+            });
+            continue;
+        }
+
+        if (claimed.compare_exchange_weak(id, id + 1, std::memory_order_relaxed))
+        {
+            try
+            {
+                DecodeChunk(id);
+            }
+            catch (const std::bad_alloc&)
+            {
+                // Out of memory; the reader inflates the chunk serially, as
+                // when its first block was guessed wrong.
+                Drop(id);
+                chunks[id].start = PARALLEL_NONE;
+                chunks[id].status = PARALLEL_MEMORY;
+            }
+            catch (...)
+            {
+                chunks[id].status = INFLATE_ERROR;
+            }
+            chunks[id].done.store(true, std::memory_order_release);
+            Signal();
+        }
+    }
+}
+
+/**
+ * Inflates a single chunk. All but the first chunk look for their first block
+ * and inflate into wide output, until the last 32K of it no longer refer to
+ * the window. Every chunk stops at the first block boundary in the next one.
+ * @param id The chunk to inflate.
+ */
+void ParallelZLibStream::DecodeChunk(size_t id)
+{
+    struct ParallelChunk *chunk = &chunks[id];
+    size_t limit, search, end, bit;
+    Inflater inflater(input, size);
+    bool wide;
+    int result;
+
+    limit = (id + 1 < count) ? chunks[id + 1].begin : (size << 3);
+    end = PARALLEL_NONE;
+
+    if (id == 0)
+    {
+        // The first block is known, at the start of the data.
+        chunk->narrow.data.resize(PARALLEL_CHUNK_SIZE);
+        chunk->narrow.size = 0;
+        chunk->narrow.history = 0;
+        chunk->narrow.marker = 0;
+        chunk->start = 0;
+        wide = false;
+
+        result = inflater.ReadHeader();
+        if (result == INFLATE_OK)
+        {
+            result = inflater.ReadBlock(&chunk->narrow);
+        }
+    }
+    else
+    {
+        // Fill the window with markers, the symbol refers to its position.
+        chunk->wide.data.resize(PARALLEL_CHUNK_SIZE);
+        for (int i = 0; i < INFLATE_WINDOW; i++)
+        {
+            chunk->wide.data[i] = (uint16_t)(INFLATE_MARKER + i);
+        }
+        chunk->wide.history = INFLATE_WINDOW;
+        wide = true;
+
+        // Guess the first block; the first offset with a valid dynamic header
+        // of which the whole block inflates. Stored data has no such header,
+        // which the reader then inflates serially.
+        result = INFLATE_ERROR;
+        search = chunk->begin + ((size_t)PARALLEL_SEARCH << 3);
+        search = (search < limit) ? search : limit;
+        for (bit = chunk->begin; bit < search && !stop.load(std::memory_order_relaxed); bit++)
+        {
+            if (!inflater.Probe(bit))
+            {
+                continue;
+            }
+
+            chunk->wide.size = INFLATE_WINDOW;
+            chunk->wide.marker = INFLATE_WINDOW;
+            result = inflater.ReadBlock(&chunk->wide);
+            if (result != INFLATE_ERROR)
+            {
+                chunk->start = bit;
+                break;
+            }
+        }
+
+        if (chunk->start == PARALLEL_NONE)
+        {
+            chunk->wide.size = 0;
+            return;
+        }
+    }
+
+    while (result == INFLATE_OK && !stop.load(std::memory_order_relaxed))
+    {
+        end = inflater.Tell();
+        if (id + 1 < count && end >= limit)
+        {
+            break;
+        }
+
+        // Continue narrow once the window is no longer referred to.
+        if (wide && (chunk->wide.size - chunk->wide.marker) >= INFLATE_WINDOW)
+        {
+            chunk->narrow.data.resize(PARALLEL_CHUNK_SIZE);
+            for (int i = 0; i < INFLATE_WINDOW; i++)
+            {
+                chunk->narrow.data[i] = (uint8_t)chunk->wide.data[chunk->wide.size - INFLATE_WINDOW + i];
+            }
+            chunk->narrow.size = INFLATE_WINDOW;
+            chunk->narrow.history = INFLATE_WINDOW;
+            chunk->narrow.marker = 0;
+            wide = false;
+        }
+
+        result = inflater.ReadHeader();
+        if (result == INFLATE_OK)
+        {
+            result = wide ? inflater.ReadBlock(&chunk->wide) : inflater.ReadBlock(&chunk->narrow);
+        }
+    }
+
+    chunk->stop = (result == INFLATE_END) ? inflater.Tell() : end;
+    chunk->status = result;
+}
+
+/**
+ * Waits for a chunk to be inflated, letting the workers move ahead.
+ * @param id The chunk to wait for.
+ */
+void ParallelZLibStream::Wait(size_t id)
+{
+    if (needed.load(std::memory_order_relaxed) < id)
+    {
+        needed.store(id, std::memory_order_release);
+        Signal();
+    }
+
+    if (!chunks[id].done.load(std::memory_order_acquire))
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this, id]
+        {
+            return chunks[id].done.load(std::memory_order_acquire);
+        });
+    }
+}
+
+/**
+ * Releases the output of a chunk once it has been read or turned out wrong.
+ * @param id The chunk to release.
+ */
+void ParallelZLibStream::Drop(size_t id)
+{
+    std::vector<uint16_t>().swap(chunks[id].wide.data);
+    std::vector<uint8_t>().swap(chunks[id].narrow.data);
+}
+
+/**
+ * Queues output to be read and keeps the last 32K of it as window.
+ * @param data The output.
+ * @param size The number of bytes of output.
+ */
+void ParallelZLibStream::Emit(uint8_t *data, size_t size)
+{
+    size_t offset;
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    // The stream counts in int, hand out large output in parts.
+    for (offset = 0; offset < size; offset += 0x40000000)
+    {
+        pieces.push_back(data + offset);
+        sizes.push_back(((size - offset) < 0x40000000) ? (size - offset) : 0x40000000);
+        adler = adler32(adler, data + offset, (uInt)sizes.back());
+    }
+
+    if (size >= INFLATE_WINDOW)
+    {
+        std::memcpy(history, data + size - INFLATE_WINDOW, INFLATE_WINDOW);
+    }
+    else
+    {
+        std::memmove(history, history + size, INFLATE_WINDOW - size);
+        std::memcpy(history + INFLATE_WINDOW - size, data, size);
+    }
+}
+
+/**
+ * Moves on to the chunk which starts where the output read so far ends. When
+ * there is none, the reader continues inflating by itself.
+ * @param id The first chunk which may start there.
+ * @return ZSTREAM_OK
+ */
+int ParallelZLibStream::Join(size_t id)
+{
+    // Chunks which start before were guessed wrong, or covered serially.
+    for (current = id; current < count; current++)
+    {
+        Wait(current);
+        if (chunks[current].start != PARALLEL_NONE && chunks[current].start >= position)
+        {
+            break;
+        }
+        Drop(current);
+    }
+
+    if (current < count && chunks[current].start == position)
+    {
+        continuing = false;
+        return ZSTREAM_OK;
+    }
+
+    if (serial == nullptr)
+    {
+        serial = new Inflater(input, size);
+    }
+    serial->Seek(position);
+    continuing = true;
+
+    return ZSTREAM_OK;
+}
+
+/**
+ * Inflates serially from the end of the output read so far, up to the start
+ * of a chunk or PARALLEL_CHUNK_SIZE bytes of output.
+ * @return A ZSTREAM_* code.
+ */
+int ParallelZLibStream::Continue(void)
+{
+    int result;
+
+    pending.data.resize(INFLATE_WINDOW + PARALLEL_CHUNK_SIZE);
+    std::memcpy(pending.data.data(), history, INFLATE_WINDOW);
+    pending.size = INFLATE_WINDOW;
+    pending.history = INFLATE_WINDOW;
+    pending.marker = 0;
+
+    do
+    {
+        result = serial->ReadHeader();
+        if (result == INFLATE_OK)
+        {
+            result = serial->ReadBlock(&pending);
+        }
+        if (result == INFLATE_ERROR)
+        {
+            return ZSTREAM_ZDATA;
+        }
+        position = serial->Tell();
+
+        if (result == INFLATE_END)
+        {
+            break;
+        }
+
+        // Passed chunks are of no use anymore, a chunk starting here is.
+        while (current < count)
+        {
+            Wait(current);
+            if (chunks[current].start != PARALLEL_NONE && chunks[current].start >= position)
+            {
+                break;
+            }
+            Drop(current);
+            current++;
+        }
+
+        if (current < count && chunks[current].start == position)
+        {
+            continuing = false;
+            break;
+        }
+    }
+    while ((pending.size - pending.history) < PARALLEL_CHUNK_SIZE);
+
+    Emit(pending.data.data() + pending.history, pending.size - pending.history);
+
+    return (result == INFLATE_END) ? Finish() : ZSTREAM_OK;
+}
+
+/**
+ * Checks the Adler-32 checksum following the final block.
+ * @return ZSTREAM_OK or ZSTREAM_ZDATA.
+ */
+int ParallelZLibStream::Finish(void)
+{
+    size_t offset = ((position + 7) >> 3);
+    unsigned long expected;
+
+    finished = true;
+
+    if (offset + 4 > size)
+    {
+        return ZSTREAM_ZDATA;
+    }
+
+    expected = ((unsigned long)input[offset] << 24) | ((unsigned long)input[offset + 1] << 16) |
+        ((unsigned long)input[offset + 2] << 8) | (unsigned long)input[offset + 3];
+
+    return (expected == adler) ? ZSTREAM_OK : ZSTREAM_ZDATA;
+}
+
+/**
+ * Queues the output of the next chunk, or continues serially.
+ * @return A ZSTREAM_* code.
+ */
+int ParallelZLibStream::Advance(void)
+{
+    struct ParallelChunk *chunk;
+
+    pieces.clear();
+    sizes.clear();
+    piece = 0;
+
+    if (held != PARALLEL_NONE)
+    {
+        Drop(held);
+        held = PARALLEL_NONE;
+    }
+
+    if (continuing)
+    {
+        return Continue();
+    }
+
+    chunk = &chunks[current];
+    Wait(current);
+    if (chunk->status == PARALLEL_MEMORY)
+    {
+        return Join(current);
+    }
+    if (chunk->status == INFLATE_ERROR)
+    {
+        return ZSTREAM_ZDATA;
+    }
+
+    // Resolve the markers, the window is the output so far.
+    if (chunk->wide.size > INFLATE_WINDOW)
+    {
+        resolved.resize(chunk->wide.size - INFLATE_WINDOW);
+        for (size_t i = 0; i < resolved.size(); i++)
+        {
+            uint16_t symbol = chunk->wide.data[INFLATE_WINDOW + i];
+
+            resolved[i] = (symbol < INFLATE_MARKER) ? (uint8_t)symbol : history[symbol - INFLATE_MARKER];
+        }
+        std::vector<uint16_t>().swap(chunk->wide.data);
+        Emit(resolved.data(), resolved.size());
+    }
+
+    if (chunk->narrow.size > chunk->narrow.history)
+    {
+        Emit(chunk->narrow.data.data() + chunk->narrow.history, chunk->narrow.size - chunk->narrow.history);
+    }
+
+    held = current;
+    position = chunk->stop;
+    if (chunk->status == INFLATE_END)
+    {
+        return Finish();
+    }
+
+    return Join(current + 1);
+}
+
+int ParallelZLibStream::Refill(void)
+{
+    int result;
+
+    for (;;)
+    {
+        /* Read straight from the output, it is kept until the next refill. */
+        if (piece < pieces.size())
+        {
+            buffer = (char*)pieces[piece];
+            available = (int)sizes[piece];
+            relPosition = 0;
+            piece++;
+            return ZSTREAM_OK;
+        }
+
+        if (finished)
+        {
+            return ZSTREAM_FREAD;
+        }
+
+        result = Advance();
+        if (result != ZSTREAM_OK)
+        {
+            return result;
+        }
+    }
+}
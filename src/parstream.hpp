@@ -0,0 +1,90 @@
+#ifndef PARSTREAM_HPP
+#define PARSTREAM_HPP
+
+#include <cstdio>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "stream.hpp"
+#include "inflater.hpp"
+
+#define PARALLEL_CHUNK_SIZE     0x400000    /* Deflated bytes per chunk. */
+#define PARALLEL_SEARCH         0x20000     /* Deflated bytes to look for a block in. */
+#define PARALLEL_AHEAD          2           /* Chunks decoded ahead of the reader, per thread. */
+#define PARALLEL_NONE           ((size_t)-1)
+#define PARALLEL_MEMORY         (-2)        /* Status of a chunk which ran out of memory. */
+
+struct ParallelChunk
+{
+    size_t begin;                       // First bit to look for a block at
+    size_t start;                       // Bit of the first block, or PARALLEL_NONE
+    size_t stop;                        // Bit past the last block
+    int status;                         // INFLATE_OK, INFLATE_END, INFLATE_ERROR or PARALLEL_MEMORY
+    InflateOutput<uint16_t> wide;       // Output while it may refer to the window
+    InflateOutput<uint8_t> narrow;      // Output once it no longer does
+    std::atomic<bool> done;
+};
+
+/**
+ * Inflates a single ZLib stream on all cores. The deflated data is split into
+ * chunks; each thread looks for the first block boundary within its chunk and
+ * inflates from there, with back references to the unknown window before it
+ * kept as markers. The reader then checks the chunks line up, resolves the
+ * markers from the output of the chunk before, and inflates serially wherever
+ * a boundary was guessed wrong. See pugz and rapidgzip for the technique.
+ */
+class ParallelZLibStream : public Stream
+{
+public:
+    ParallelZLibStream(const void *input, size_t size);
+    ~ParallelZLibStream(void);
+
+protected:
+    int Refill(void);
+
+private:
+    void Signal(void);
+    void Work(void);
+    void DecodeChunk(size_t id);
+    void Wait(size_t id);
+    void Drop(size_t id);
+    int Advance(void);
+    int Join(size_t id);
+    int Continue(void);
+    int Finish(void);
+    void Emit(uint8_t *data, size_t size);
+
+private:
+    const uint8_t *input;
+    size_t size;
+
+    struct ParallelChunk *chunks;
+    size_t count;
+    std::vector<std::thread> workers;
+    size_t ahead;
+    std::atomic<size_t> claimed;
+    std::atomic<size_t> needed;
+    std::atomic<bool> stop;
+    std::mutex lock;
+    std::condition_variable changed;   // needed, a chunk being done or stop
+
+    // State of the reader
+    size_t current;                     // Chunk read next, or joined next when continuing
+    size_t held;                        // Chunk of which the output is being read
+    size_t position;                    // Bit past the blocks read so far
+    bool continuing;
+    bool finished;
+    Inflater *serial;
+    InflateOutput<uint8_t> pending;
+    std::vector<uint8_t> resolved;
+    std::vector<uint8_t*> pieces;
+    std::vector<size_t> sizes;
+    size_t piece;
+    unsigned long adler;
+    uint8_t history[INFLATE_WINDOW];
+};
+
+#endif /* PARSTREAM_HPP */
@@ -0,0 +1,204 @@
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <exception>
+#include <new>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
+#include "stream.hpp"
+#include "zstream.hpp"
+#include "pipestream.hpp"
+
+/**
+ * Creates the stream and starts inflating the input on a worker thread.
+ * @param input The deflated data, must outlive the stream.
+ * @param size The number of bytes of deflated data.
+ */
+PipelinedZLibStream::PipelinedZLibStream(const void *input, size_t size) :
+    Stream(nullptr), head(0), tail(0), stop(false), status(ZSTREAM_OK)
+{
+    holding = false;
+
+    if (size > UINT_MAX)
+    {
+        throw std::exception("Input too large for ZLib.\n");
+    }
+
+    std::memset(&zStruct, 0, sizeof(z_stream));
+    zStruct.zalloc = Z_NULL;
+    zStruct.zfree = Z_NULL;
+    zStruct.opaque = Z_NULL;
+    zStruct.avail_in = (uInt)size;
+    zStruct.next_in = (Bytef*)input;
+
+    if (Z_OK != inflateInit(&zStruct))
+    {
+        throw std::exception("Failed to initialize ZLib.\n");
+    }
+
+    chunks = new (std::nothrow) PipelineChunk[PIPELINE_CHUNKS];
+    if (chunks == nullptr)
+    {
+        inflateEnd(&zStruct);
+        throw std::exception("Could not allocate pipeline chunks.\n");
+    }
+
+    try
+    {
+        worker = std::thread(&PipelinedZLibStream::Produce, this);
+    }
+    catch (...)
+    {
+        delete[] chunks;
+        inflateEnd(&zStruct);
+        throw;
+    }
+}
+
+/**
+ * Stops the worker, which may still be inflating ahead, and releases ZLib.
+ */
+PipelinedZLibStream::~PipelinedZLibStream(void)
+{
+    stop.store(true, std::memory_order_relaxed);
+    Signal();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+
+    delete[] chunks;
+    inflateEnd(&zStruct);
+}
+
+/**
+ * Wakes the other side after a counter, the status or the stop flag changed.
+ * Taking the lock orders the change before a waiter checking it under the
+ * lock, hence the wake up cannot be lost.
+ */
+void PipelinedZLibStream::Signal(void)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+    }
+    changed.notify_all();
+}
+
+/**
+ * Worker thread; inflates chunk by chunk until the data ends, an error occurs
+ * or the stream is destroyed.
+ */
+void PipelinedZLibStream::Produce(void)
+{
+    struct PipelineChunk *chunk;
+    unsigned int produced;
+    int result;
+
+    for (produced = 0; !stop.load(std::memory_order_relaxed); )
+    {
+        /* Wait for the reader to hand back a chunk. */
+        if ((produced - tail.load(std::memory_order_acquire)) >= PIPELINE_CHUNKS)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [this, produced]
+            {
+                return stop.load(std::memory_order_relaxed) ||
+                    (produced - tail.load(std::memory_order_acquire)) < PIPELINE_CHUNKS;
+            });
+            if (stop.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+
+        chunk = &chunks[produced % PIPELINE_CHUNKS];
+
+        zStruct.avail_out = PIPELINE_CHUNK_SIZE;
+        zStruct.next_out = (Bytef*)chunk->data;
+
+        result = inflate(&zStruct, Z_NO_FLUSH);
+
+        /* Fatal */
+        if (result == Z_STREAM_ERROR)
+        {
+            status.store(ZSTREAM_ZERROR, std::memory_order_release);
+            Signal();
+            return;
+        }
+
+        /* Corrupted data */
+        if (result == Z_NEED_DICT ||
+            result == Z_DATA_ERROR ||
+            result == Z_MEM_ERROR)
+        {
+            status.store(ZSTREAM_ZDATA, std::memory_order_release);
+            Signal();
+            return;
+        }
+
+        /* Publish the chunk to the reader. */
+        chunk->size = (PIPELINE_CHUNK_SIZE - (int)zStruct.avail_out);
+        if (chunk->size > 0)
+        {
+            produced++;
+            head.store(produced, std::memory_order_release);
+            Signal();
+        }
+
+        /* No more data or no progress possible */
+        if (result == Z_STREAM_END || result == Z_BUF_ERROR)
+        {
+            status.store(ZSTREAM_FREAD, std::memory_order_release);
+            Signal();
+            return;
+        }
+    }
+}
+
+int PipelinedZLibStream::Refill(void)
+{
+    struct PipelineChunk *chunk;
+    unsigned int consumed;
+    int result;
+
+    consumed = tail.load(std::memory_order_relaxed);
+
+    /* Hand the chunk which has been read back to the worker. */
+    if (holding)
+    {
+        consumed++;
+        tail.store(consumed, std::memory_order_release);
+        holding = false;
+        Signal();
+    }
+
+    /* Wait for the worker to publish the next chunk. */
+    if (head.load(std::memory_order_acquire) == consumed)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this, consumed]
+        {
+            return head.load(std::memory_order_acquire) != consumed ||
+                status.load(std::memory_order_acquire) != ZSTREAM_OK;
+        });
+
+        // The worker publishes its last chunk before it stops, check again.
+        result = status.load(std::memory_order_acquire);
+        if (result != ZSTREAM_OK && head.load(std::memory_order_acquire) == consumed)
+        {
+            return result;
+        }
+    }
+
+    /* Read straight from the chunk, it is ours until the next refill. */
+    chunk = &chunks[consumed % PIPELINE_CHUNKS];
+    buffer = chunk->data;
+    available = chunk->size;
+    relPosition = 0;
+    holding = true;
+
+    return ZSTREAM_OK;
+}
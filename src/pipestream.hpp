@@ -0,0 +1,55 @@
+#ifndef PIPESTREAM_HPP
+#define PIPESTREAM_HPP
+
+#include <cstdio>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
+#include "stream.hpp"
+
+#define PIPELINE_CHUNKS         8
+#define PIPELINE_CHUNK_SIZE     0x10000
+
+struct PipelineChunk
+{
+    char data[PIPELINE_CHUNK_SIZE];
+    int size;
+};
+
+/**
+ * Inflates on a worker thread ahead of the reader. The worker fills a ring of
+ * chunks which is shared with the reader without locks; there is exactly one
+ * producer (the worker) and one consumer (the thread reading the stream).
+ * Either side blocks on a condition variable while the ring is full or empty.
+ */
+class PipelinedZLibStream : public Stream
+{
+public:
+    PipelinedZLibStream(const void *input, size_t size);
+    ~PipelinedZLibStream(void);
+
+protected:
+    int Refill(void);
+
+private:
+    void Produce(void);
+    void Signal(void);
+
+private:
+    z_stream zStruct;
+    struct PipelineChunk *chunks;
+    std::thread worker;
+
+    // Number of chunks produced and consumed, the ring index is modulo.
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+    std::atomic<bool> stop;
+    std::atomic<int> status;
+    std::mutex lock;
+    std::condition_variable changed;
+    bool holding;
+};
+
+#endif /* PIPESTREAM_HPP */
@@ -0,0 +1,23 @@
+#ifndef POLICY_HPP
+#define POLICY_HPP
+
+#include "utility.hpp"
+
+/** Validates all of the data, for zones from anywhere. */
+struct Checked
+{
+    static constexpr bool enabled = true;
+};
+
+/** Skips the validation, for zones known to be good, see LOAD_TRUSTED. */
+struct Unchecked
+{
+    static constexpr bool enabled = false;
+};
+
+/** An ASSERT which only a Checked policy evaluates. */
+#ifndef CHECK
+#   define CHECK(Policy, ex, fmt, ...)  if (Policy::enabled && !(ex)) { throw Exception(__LINE__, __FILE__, fmt, ##__VA_ARGS__); }
+#endif
+
+#endif /* POLICY_HPP */
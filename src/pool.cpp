@@ -0,0 +1,133 @@
+#include <cstdlib>
+#include "utility.hpp"
+#include "asset.hpp"
+#include "registry.hpp"
+#include "pool.hpp"
+
+AssetPool::AssetPool(void)
+{
+    block = nullptr;
+    for (int type = 0; type < ASSET_TYPE_COUNT; type++)
+    {
+        buckets[type] = { nullptr, 0, 0, 0 };
+    }
+}
+
+AssetPool::~AssetPool(void)
+{
+    Release();
+}
+
+void AssetPool::Release(void) noexcept
+{
+    // The assets may own memory of their own, hence destroy each.
+    for (int type = 0; type < ASSET_TYPE_COUNT; type++)
+    {
+        for (int n = 0; n < buckets[type].count; n++)
+        {
+            GetAsset(type, n)->~Asset();
+        }
+        buckets[type] = { nullptr, 0, 0, 0 };
+    }
+
+    if (block != nullptr)
+    {
+        free(block);
+        block = nullptr;
+    }
+}
+
+/**
+ * Allocates the block for all the assets, a pool can only reserve once.
+ * @param counts The number of assets per ASSET_TYPE_*.
+ */
+void AssetPool::Reserve(const int *counts)
+{
+    size_t size = 0;
+
+    ASSERT(block == nullptr, "Asset pool already reserved.");
+
+    // Lay out the buckets, by type.
+    for (int type = 0; type < ASSET_TYPE_COUNT; type++)
+    {
+        if (counts[type] > 0)
+        {
+            ASSERT(assetTypes[type].create != nullptr,
+                "Can not pool an unsupported asset type. (%s)",
+                    lpAssetType[type]
+            );
+
+            size = ALIGN(size, (size_t)POOL_ALIGNMENT);
+            buckets[type].begin = (char*)size;
+            buckets[type].stride = assetTypes[type].object;
+            buckets[type].capacity = counts[type];
+            size += (buckets[type].stride * counts[type]);
+        }
+    }
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    block = (char*)malloc(size);
+    if (block == nullptr)
+    {
+        throw Exception("Out of memory (asset pool)");
+    }
+
+    // Turn the offsets into pointers.
+    for (int type = 0; type < ASSET_TYPE_COUNT; type++)
+    {
+        if (buckets[type].capacity > 0)
+        {
+            buckets[type].begin = block + (size_t)buckets[type].begin;
+        }
+    }
+}
+
+/**
+ * Constructs the next asset of a type.
+ * @param type The ASSET_TYPE_* type.
+ */
+class Asset* AssetPool::Create(int type)
+{
+    struct AssetBucket *bucket;
+    class Asset *asset;
+    char *memory;
+
+    ASSERT(type >= 0 && type < ASSET_TYPE_COUNT, "Invalid asset type. (0x%02X)", type);
+
+    bucket = &buckets[type];
+    ASSERT(bucket->count < bucket->capacity,
+        "Asset pool exhausted. (%s, %i)",
+            lpAssetType[type], bucket->capacity
+    );
+
+    memory = bucket->begin + (bucket->stride * bucket->count);
+    asset = assetTypes[type].create(memory);
+    ASSERT((char*)asset == memory, "Asset not at the start of its memory. (%s)", lpAssetType[type]);
+    bucket->count++;
+    return asset;
+}
+
+int AssetPool::GetCount(int type)
+{
+    return buckets[type].count;
+}
+
+size_t AssetPool::GetStride(int type)
+{
+    return buckets[type].stride;
+}
+
+/**
+ * Gets an asset by its place within its type.
+ * @param type The ASSET_TYPE_* type.
+ * @param n The number of the asset within the type.
+ */
+class Asset* AssetPool::GetAsset(int type, int n)
+{
+    // The assets are at the start of their memory, see Create.
+    return (class Asset*)(buckets[type].begin + (buckets[type].stride * n));
+}
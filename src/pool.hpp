@@ -0,0 +1,42 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include "utility.hpp"
+#include "asset.hpp"
+
+#define POOL_ALIGNMENT      16          /* Of each bucket within the block. */
+
+/** The assets of one type, adjacent in the order they are created. */
+struct AssetBucket
+{
+    char *begin;
+    size_t stride;                      // sizeof the asset class
+    int count;
+    int capacity;
+};
+
+/**
+ * The asset objects of a fast file. Every asset is constructed in place in a
+ * single block, which holds one array per type. Releasing destroys the assets
+ * and frees the block once, instead of deleting each asset.
+ */
+class AssetPool
+{
+public:
+    AssetPool(void);
+    ~AssetPool(void);
+    void Release(void) noexcept;
+
+    void Reserve(const int *counts);
+    class Asset* Create(int type);
+
+    int GetCount(int type);
+    size_t GetStride(int type);
+    class Asset* GetAsset(int type, int n);
+
+private:
+    char *block;
+    struct AssetBucket buckets[ASSET_TYPE_COUNT];
+};
+
+#endif /* POOL_HPP */
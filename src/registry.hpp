@@ -0,0 +1,80 @@
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include <new>
+#include "utility.hpp"
+#include "asset.hpp"
+#include "assets/physpreset.hpp"        /* x01 */
+#include "assets/xanim.hpp"             /* x02 */
+#include "assets/xmodel.hpp"            /* x03 */
+#include "assets/material.hpp"          /* x04 */
+#include "assets/techset.hpp"           /* x05 */
+#include "assets/image.hpp"             /* x06 */
+#include "assets/sound.hpp"             /* x07 */
+#include "assets/sndcurve.hpp"          /* x08 */
+#include "assets/loadedsound.hpp"       /* x09 */
+#include "assets/localize.hpp"          /* x16 */
+#include "assets/weapon.hpp"            /* x17 */
+#include "assets/rawfile.hpp"           /* x1F */
+#include "assets/stringtable.hpp"       /* x20 */
+
+/**
+ * What is known of an asset type. Loading, dumping and exporting go through
+ * the virtual methods of the asset created here.
+ */
+struct AssetType
+{
+    int size;                           // Of the fixed part, see docs/types.h; a loaded asset reads at least this
+    size_t object;                      // sizeof the asset class, see AssetPool
+    class Asset* (*create)(void *memory); // nullptr when not yet implemented
+};
+
+/** Constructs an asset in the given memory of sizeof(T) bytes. */
+template <class T>
+class Asset* CreateAsset(void *memory)
+{
+    return new (memory) T();
+}
+
+#define ASSET_TYPE(size, T)     { size, sizeof(T), CreateAsset<T> }
+#define ASSET_TYPE_NONE(size)   { size, 0, nullptr }
+
+/** The asset types by ASSET_TYPE_*, adding a type takes one entry. */
+static constexpr struct AssetType assetTypes[ASSET_TYPE_COUNT] =
+{
+    ASSET_TYPE_NONE(0x000C),                        /* xmodelpieces */
+    ASSET_TYPE(0x002C, Physpreset),                 /* physpreset */
+    ASSET_TYPE(0x0058, XAnim),                      /* xanim */
+    ASSET_TYPE(0x00DC, XModel),                     /* xmodel */
+    ASSET_TYPE(0x0050, Material),                   /* material */
+    ASSET_TYPE(0x0094, Techset),                    /* techset */
+    ASSET_TYPE(0x0024, Image),                      /* image */
+    ASSET_TYPE(0x000C, Sound),                      /* sound */
+    ASSET_TYPE(0x0048, SndCurve),                   /* sndcurve */
+    ASSET_TYPE(0x002C, LoadedSound),                /* loaded_sound */
+    ASSET_TYPE_NONE(0x011C),                        /* col_map_sp */
+    ASSET_TYPE_NONE(0x011C),                        /* col_map_mp */
+    ASSET_TYPE_NONE(0x0010),                        /* com_map */
+    ASSET_TYPE_NONE(0x002C),                        /* game_map_sp */
+    ASSET_TYPE_NONE(0x0004),                        /* game_map_mp */
+    ASSET_TYPE_NONE(0x000C),                        /* map_ents */
+    ASSET_TYPE_NONE(0x02DC),                        /* gfx_map */
+    ASSET_TYPE_NONE(0x0010),                        /* lightdef */
+    ASSET_TYPE_NONE(0x0000),                        /* ui_map, not in fast files */
+    ASSET_TYPE_NONE(0x0018),                        /* font */
+    ASSET_TYPE_NONE(0x000C),                        /* menufile */
+    ASSET_TYPE_NONE(0x011C),                        /* menu */
+    ASSET_TYPE(0x0008, Localize),                   /* localize */
+    ASSET_TYPE(0x0878, Weapon),                     /* weapon */
+    ASSET_TYPE_NONE(0x0000),                        /* snddriverglobals, not in fast files */
+    ASSET_TYPE_NONE(0x0020),                        /* fx */
+    ASSET_TYPE_NONE(0x0008),                        /* impactfx */
+    ASSET_TYPE_NONE(0x0000),                        /* aitype, not in fast files */
+    ASSET_TYPE_NONE(0x0000),                        /* mptype, not in fast files */
+    ASSET_TYPE_NONE(0x0000),                        /* character, not in fast files */
+    ASSET_TYPE_NONE(0x0000),                        /* xmodelalias, not in fast files */
+    ASSET_TYPE(0x000C, Rawfile),                    /* rawfile */
+    ASSET_TYPE(0x0010, Stringtable),                /* stringtable */
+};
+
+#endif /* REGISTRY_HPP */
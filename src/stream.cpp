@@ -7,10 +7,14 @@
 Stream::Stream(std::FILE *source)
 {
     this->source = source;
-    std::memset(buffer, 0, BUFFER_SIZE);
+    this->buffer = window;
+    std::memset(window, 0, BUFFER_SIZE);
     this->absPosition = 0;
     this->relPosition = 0;
     this->available = 0;
+    this->saved = nullptr;
+    this->savedPosition = 0;
+    this->savedAvailable = 0;
 }
 
 Stream::~Stream(void)
@@ -23,47 +27,172 @@ int Stream::GetPosition(void)
     return absPosition;
 }
 
+/**
+ * Continues with the next bytes; the rest of the buffer left by Peek(), or
+ * else a refill.
+ */
+int Stream::Next(void)
+{
+    if (saved != nullptr)
+    {
+        buffer = saved;
+        relPosition = savedPosition;
+        available = savedAvailable;
+        saved = nullptr;
+
+        if (available > 0)
+        {
+            return 0;
+        }
+    }
+
+    return Refill();
+}
+
+/**
+ * Gets the next bytes without reading them. When they straddle a refill they
+ * are gathered in a scratch buffer first.
+ * @param size The number of bytes, at most PEEK_SIZE.
+ * @return The bytes, valid until the next read.
+ */
+const char* Stream::Peek(int size)
+{
+    int copied, length;
+
+    /* Contiguous */
+    if (size <= available)
+    {
+        return (buffer + relPosition);
+    }
+
+    if (size > PEEK_SIZE)
+    {
+        throw std::exception("Peek size exceeded.\n");
+    }
+
+    /* The buffer may be the scratch already, hence the move. */
+    copied = (available > 0) ? available : 0;
+    memmove(scratch, buffer + relPosition, copied);
+    available = 0;
+
+    while (copied < size)
+    {
+        if (Next())
+        {
+            throw std::exception("Could not refill PEEK buffer.\n");
+        }
+
+        length = ((size - copied) < available) ? (size - copied) : available;
+        memcpy(scratch + copied, buffer + relPosition, length);
+
+        copied += length;
+        relPosition += length;
+        available -= length;
+    }
+
+    /* Read from the scratch, then continue with the rest of the buffer. */
+    saved = buffer;
+    savedPosition = relPosition;
+    savedAvailable = available;
+
+    buffer = scratch;
+    relPosition = 0;
+    available = size;
+
+    return scratch;
+}
+
+/**
+ * Reads bytes which have been peeked at.
+ * @param size The number of bytes, at most the number peeked at.
+ */
+void Stream::Consume(int size)
+{
+    if (size > available)
+    {
+        throw std::exception("Consumed more than peeked.\n");
+    }
+
+    absPosition += size;
+    relPosition += size;
+    available -= size;
+}
+
+/**
+ * Reads bytes straight into the destination, bypassing the buffer. Used for
+ * large reads once the buffer has been drained. Streams which can not do so
+ * read nothing and the bytes go through the buffer instead.
+ * @param dest The destination to read to.
+ * @param size The number of bytes requested.
+ * @return The number of bytes read, or negative on error.
+ */
+int Stream::ReadDirect(char *dest, int size)
+{
+    (void)dest;
+    (void)size;
+    return 0;
+}
+
+/**
+ * Reads a zero-terminated string. The buffered bytes are scanned for the
+ * terminator with memchr and copied in one go, refilling only at the end of
+ * the buffer.
+ * @param dest The destination to read to.
+ * @param max The size of the destination, or -1 when unbounded.
+ * @return The number of characters read, including the terminator.
+ */
 int Stream::ReadString(char *dest, int max)
 {
-    int index;
+    const char *found;
+    int index, length;
 
-    /* Keep looping till the maximum amount of characters. */
-    for (index = 0; (max == -1 || index < max); index++)
+    for (index = 0; ; index += length)
     {
         /* Check for a refill. */
         if (available <= 0)
         {
-            if (Refill())
+            if (Next())
             {
                 throw std::exception("Could not refill STRING buffer.\n");
                 return -1;
             }
         }
 
-        /* Copy the character. */
-        dest[index] = buffer[relPosition];
+        /* Scan no further than the buffer or the destination allows. */
+        length = available;
+        if (max != -1 && length > (max - index))
+        {
+            length = (max - index);
+        }
+
+        found = (const char*)memchr(buffer + relPosition, 0, length);
+        if (found != nullptr)
+        {
+            length = (int)(found - (buffer + relPosition)) + 1;
+        }
+
+        /* Copy the characters. */
+        memcpy(dest + index, buffer + relPosition, length);
 
         /* Update the positions. */
-        absPosition++;
-        relPosition++;
-        available--;
+        absPosition += length;
+        relPosition += length;
+        available -= length;
 
         /* Check for the string-terminator. */
-        if (dest[index] == 0)
+        if (found != nullptr)
         {
             /* Return immediately. */
-            return (index + 1);
+            return (index + length);
         }
-    }
 
-    /* Ensure the string is zero-terminated. */
-    if (max != -1 && index == max)
-    {
-        dest[max-1] = 0;
-        throw std::exception("String buffer too small.\n");
+        /* Ensure the string is zero-terminated. */
+        if (max != -1 && (index + length) == max)
+        {
+            dest[max-1] = 0;
+            throw std::exception("String buffer too small.\n");
+        }
     }
-
-    return -1;
 }
 
 int Stream::ReadMemory(void *dest, int size)
@@ -76,10 +205,31 @@ int Stream::ReadMemory(void *dest, int size)
 
     do
     {
+        /* Large reads skip the buffer once it has been drained. */
+        if (available <= 0 && saved == nullptr && size >= DIRECT_SIZE)
+        {
+            result = ReadDirect(buffer, size);
+            if (result < 0)
+            {
+                throw std::exception("Could not read DIRECT bytes.\n");
+                return -1;
+            }
+
+            /* Update the destination and positions. */
+            buffer += result;
+            size -= result;
+            absPosition += result;
+
+            if (size == 0)
+            {
+                return written;
+            }
+        }
+
         /* Check for a refill. */
         if (available <= 0)
         {
-            result = Refill();
+            result = Next();
             if (result)
             {
                 throw std::exception("Could not refill BYTE buffer.\n");
@@ -4,27 +4,44 @@
 #include <cstdio>
 
 #define BUFFER_SIZE 16384
+#define DIRECT_SIZE 4096
+#define PEEK_SIZE 256
 
 class Stream
 {
 public:
     Stream(std::FILE *source);
-    ~Stream(void);
+    virtual ~Stream(void);
 
     int ReadString(char *dest, int max);
     int ReadMemory(void *dest, int size);
 
+    const char* Peek(int size);
+    void Consume(int size);
+
     int GetPosition(void);
 
 protected:
     virtual int Refill(void) = 0;
+    virtual int ReadDirect(char *dest, int size);
+
+private:
+    int Next(void);
 
 protected:
-    char buffer[BUFFER_SIZE];
+    char window[BUFFER_SIZE];
+    char *buffer;
     std::FILE *source;
     int absPosition;
     int relPosition;
     int available;
+
+private:
+    // Bytes gathered by Peek() across a refill, and the rest of the buffer.
+    char scratch[PEEK_SIZE];
+    char *saved;
+    int savedPosition;
+    int savedAvailable;
 };
 
 #endif /* STREAM_HPP */
@@ -50,7 +50,9 @@
 
 #ifndef VERBOSE
 #   ifdef DEBUG
-#       define VERBOSE(fmt, ...)        fprintf(stderr, fmt, ##__VA_ARGS__)
+        // Set by FastFile::Scan, which lists the assets and prints nothing else.
+        extern thread_local bool verboseMuted;
+#       define VERBOSE(fmt, ...)        if (!verboseMuted) { fprintf(stderr, fmt, ##__VA_ARGS__); }
 #   else
 #       define VERBOSE(fmt, ...)        /* Not in RELEASE mode */
 #   endif
@@ -71,4 +73,15 @@
 /** Used within the fast files. */
 typedef unsigned int address_t;
 
+/**
+ * A typed array within the memory of a fast file. Nothing is copied, the data
+ * is valid as long as the fast file is loaded.
+ */
+template <class T>
+struct Span
+{
+    const T *data;
+    int count;
+};
+
 #endif /* UTILITY_HPP */
@@ -0,0 +1,232 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "utility.hpp"
+#include "writer.hpp"
+
+Writer::Writer(void)
+{
+    file = INVALID_HANDLE_VALUE;
+    used = 0;
+
+    buffer = (char*)malloc(WRITER_BUFFER_SIZE);
+    if (buffer == nullptr)
+    {
+        throw Exception("Out of memory (writer)");
+    }
+}
+
+Writer::~Writer(void)
+{
+    Release();
+    free(buffer);
+}
+
+/**
+ * Closes the file without writing what is left, e.g. after an exception.
+ */
+void Writer::Release(void) noexcept
+{
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+
+    used = 0;
+}
+
+/**
+ * Creates a file, or truncates it when it exists.
+ * @param path The UNICODE path of the file.
+ */
+void Writer::Open(const wchar_t *path)
+{
+    ASSERT(file == INVALID_HANDLE_VALUE, "Writer already open.");
+
+    file = CreateFileW(
+        path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw Exception("Could not create file at path '%ls'.", path);
+    }
+
+    used = 0;
+}
+
+/**
+ * Writes what is left in the buffer and closes the file.
+ */
+void Writer::Close(void)
+{
+    Flush();
+    Release();
+}
+
+void Writer::Flush(void)
+{
+    DWORD written;
+
+    if (used > 0)
+    {
+        if (!WriteFile(file, buffer, (DWORD)used, &written, nullptr) || written != used)
+        {
+            Release();
+            throw Exception("Could not write %zu bytes.", used);
+        }
+        used = 0;
+    }
+}
+
+void Writer::Write(const char *data, size_t size)
+{
+    size_t part;
+
+    while (size > 0)
+    {
+        if (used == WRITER_BUFFER_SIZE)
+        {
+            Flush();
+        }
+
+        part = WRITER_BUFFER_SIZE - used;
+        if (part > size)
+        {
+            part = size;
+        }
+
+        memcpy(buffer + used, data, part);
+        used += part;
+        data += part;
+        size -= part;
+    }
+}
+
+/**
+ * Writes data straight to the file after what is buffered, without copying
+ * it into the buffer. Meant for large data which is already in memory, e.g.
+ * the samples of a sound.
+ * @param data The data to write.
+ * @param size The number of bytes.
+ */
+void Writer::WriteThrough(const char *data, size_t size)
+{
+    DWORD part, written;
+
+    Flush();
+
+    while (size > 0)
+    {
+        part = (size > WRITER_THROUGH_SIZE) ? WRITER_THROUGH_SIZE : (DWORD)size;
+        if (!WriteFile(file, data, part, &written, nullptr) || written != part)
+        {
+            Release();
+            throw Exception("Could not write %zu bytes.", size);
+        }
+        data += part;
+        size -= part;
+    }
+}
+
+void Writer::WriteString(const char *text)
+{
+    Write(text, strlen(text));
+}
+
+void Writer::WriteInt(int value)
+{
+    char digits[16];
+    unsigned int rest;
+    int n = 0;
+
+    if ((used + WRITER_NUMBER_SIZE) > WRITER_BUFFER_SIZE)
+    {
+        Flush();
+    }
+
+    if (value < 0)
+    {
+        buffer[used++] = '-';
+        rest = 0u - (unsigned int)value;
+    }
+    else
+    {
+        rest = (unsigned int)value;
+    }
+
+    do
+    {
+        digits[n++] = (char)('0' + (rest % 10));
+        rest /= 10;
+    } while (rest != 0);
+
+    while (n > 0)
+    {
+        buffer[used++] = digits[--n];
+    }
+}
+
+/**
+ * Writes a float like %f does, with six decimals. The value times a million
+ * is exact in a double for every float, so rounding it half to even gives
+ * the very digits of printf. Values too large for that are left to it.
+ * @param value The value to write.
+ */
+void Writer::WriteFloat(float value)
+{
+    unsigned long long scaled, whole;
+    unsigned int fraction;
+    double exact, rounded;
+    char digits[24];
+    int n = 0;
+
+    if ((used + WRITER_NUMBER_SIZE) > WRITER_BUFFER_SIZE)
+    {
+        Flush();
+    }
+
+    if (!(value > -1e12f && value < 1e12f))
+    {
+        used += (size_t)snprintf(buffer + used, WRITER_NUMBER_SIZE, "%f", value);
+        return;
+    }
+
+    if (std::signbit(value))
+    {
+        buffer[used++] = '-';
+        value = -value;
+    }
+
+    exact = ((double)value * 1000000.0);
+    rounded = std::floor(exact);
+    if ((exact - rounded) > 0.5 || ((exact - rounded) == 0.5 && std::fmod(rounded, 2.0) != 0.0))
+    {
+        rounded += 1.0;
+    }
+
+    scaled = (unsigned long long)rounded;
+    whole = (scaled / 1000000);
+    fraction = (unsigned int)(scaled % 1000000);
+
+    do
+    {
+        digits[n++] = (char)('0' + (whole % 10));
+        whole /= 10;
+    } while (whole != 0);
+
+    while (n > 0)
+    {
+        buffer[used++] = digits[--n];
+    }
+
+    buffer[used++] = '.';
+    for (int i = 5; i >= 0; i--)
+    {
+        buffer[used + i] = (char)('0' + (fraction % 10));
+        fraction /= 10;
+    }
+    used += 6;
+}
@@ -0,0 +1,49 @@
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include "utility.hpp"
+
+#define WRITER_BUFFER_SIZE  0x100000    /* Written to the file at once. */
+#define WRITER_NUMBER_SIZE  64          /* Room a formatted number takes at most. */
+#define WRITER_THROUGH_SIZE 0x40000000  /* Written to the file at once, bypassing the buffer. */
+
+/**
+ * Writes a text file through one large buffer, with numbers formatted in
+ * place instead of by fprintf. The buffer is kept across files, hence one
+ * writer can write any number of them in turn.
+ */
+class Writer
+{
+public:
+    Writer(void);
+    ~Writer(void);
+
+    void Open(const wchar_t *path);
+    void Close(void);
+
+    void Write(const char *data, size_t size);
+    void WriteThrough(const char *data, size_t size);
+    void WriteString(const char *text);
+    void WriteInt(int value);
+    void WriteFloat(float value);
+
+    void WriteChar(char c)
+    {
+        if (used == WRITER_BUFFER_SIZE)
+        {
+            Flush();
+        }
+        buffer[used++] = c;
+    }
+
+private:
+    void Flush(void);
+    void Release(void) noexcept;
+
+private:
+    HANDLE file;
+    char *buffer;
+    size_t used;
+};
+
+#endif /* WRITER_HPP */
@@ -0,0 +1,385 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <zlib.h>
+
+#include "utility.hpp"
+#include "buffer.hpp"
+#include "stream.hpp"
+#include "zindex.hpp"
+
+ZIndex::ZIndex(void)
+{
+    // Nothing to initialize.
+}
+
+ZIndex::~ZIndex(void)
+{
+    Release();
+}
+
+void ZIndex::Release(void) noexcept
+{
+    for (size_t i = 0; i < checkpoints.size(); i++)
+    {
+        free(checkpoints[i]);
+    }
+    checkpoints.clear();
+
+    for (size_t i = 0; i < assets.size(); i++)
+    {
+        free(assets[i].name);
+    }
+    assets.clear();
+}
+
+/**
+ * Records a checkpoint, to be called when inflate stopped at a block boundary.
+ * Checkpoints closer than ZINDEX_SPAN to the previous one are skipped.
+ * @param strm The inflate state, stopped through Z_BLOCK.
+ */
+void ZIndex::AddCheckpoint(z_stream *strm)
+{
+    struct ZCheckpoint *point;
+    uInt length;
+
+    // Only at the end of a block, but not at the end of the last one.
+    if ((strm->data_type & 128) == 0 || (strm->data_type & 64) != 0)
+    {
+        return;
+    }
+
+    if (strm->total_out == 0 ||
+        (!checkpoints.empty() && (strm->total_out - checkpoints.back()->out) < ZINDEX_SPAN) ||
+        (checkpoints.empty() && strm->total_out < ZINDEX_SPAN))
+    {
+        return;
+    }
+
+    point = (struct ZCheckpoint*)malloc(sizeof(struct ZCheckpoint));
+    if (point == nullptr)
+    {
+        throw Exception("Out of memory (checkpoint)");
+    }
+
+    point->out = (unsigned int)strm->total_out;
+    point->in = (unsigned int)strm->total_in;
+    point->bits = (strm->data_type & 7);
+
+    // The window holds the last 32K of output, which back references may use.
+    length = ZINDEX_WINDOW;
+    if (inflateGetDictionary(strm, point->window, &length) != Z_OK)
+    {
+        free(point);
+        throw Exception("Could not copy the inflate window.");
+    }
+    point->window_s = (int)length;
+
+    checkpoints.push_back(point);
+}
+
+/**
+ * Records the decompressed range of an asset.
+ * @param type The type of the asset.
+ * @param name The name of the asset, may be nullptr.
+ * @param start The offset of the first byte.
+ * @param end The offset past the last byte.
+ */
+void ZIndex::AddAsset(int type, const char *name, unsigned int start, unsigned int end)
+{
+    struct ZIndexEntry entry;
+
+    entry.type = type;
+    entry.start = start;
+    entry.end = end;
+    entry.name = _strdup((name != nullptr) ? name : "");
+    if (entry.name == nullptr)
+    {
+        throw Exception("Out of memory (index)");
+    }
+
+    assets.push_back(entry);
+}
+
+/**
+ * Identifies the deflated data an index belongs to; its size and Adler-32.
+ */
+unsigned int ZIndex::Signature(const char *input, size_t size)
+{
+    unsigned int adler = 0;
+
+    if (size >= 4)
+    {
+        memcpy(&adler, (input + size - 4), 4);
+    }
+
+    return (adler ^ (unsigned int)size);
+}
+
+/**
+ * Writes the index to file.
+ * @param path The path of the index file.
+ * @param input The deflated data the index belongs to.
+ * @param size The number of bytes of deflated data.
+ */
+void ZIndex::Save(const wchar_t *path, const char *input, size_t size)
+{
+    std::FILE *file;
+    int header[5], entry[4];
+    bool failed = false;
+
+    if (_wfopen_s(&file, path, L"wb"))
+    {
+        throw Exception("Could not open index at path '%ls'.", path);
+    }
+
+    header[0] = ZINDEX_MAGIC;
+    header[1] = ZINDEX_VERSION;
+    header[2] = (int)Signature(input, size);
+    header[3] = (int)checkpoints.size();
+    header[4] = (int)assets.size();
+    failed |= (fwrite(header, sizeof(header), 1, file) != 1);
+
+    for (size_t i = 0; i < checkpoints.size() && !failed; i++)
+    {
+        struct ZCheckpoint *point = checkpoints[i];
+
+        entry[0] = (int)point->out;
+        entry[1] = (int)point->in;
+        entry[2] = point->bits;
+        entry[3] = point->window_s;
+        failed |= (fwrite(entry, sizeof(entry), 1, file) != 1);
+        failed |= (fwrite(point->window, 1, point->window_s, file) != (size_t)point->window_s);
+    }
+
+    for (size_t i = 0; i < assets.size() && !failed; i++)
+    {
+        entry[0] = assets[i].type;
+        entry[1] = (int)assets[i].start;
+        entry[2] = (int)assets[i].end;
+        entry[3] = (int)strlen(assets[i].name);
+        failed |= (fwrite(entry, sizeof(entry), 1, file) != 1);
+        failed |= (fwrite(assets[i].name, 1, entry[3], file) != (size_t)entry[3]);
+    }
+
+    fclose(file);
+
+    if (failed)
+    {
+        throw Exception("Could not write index to '%ls'.", path);
+    }
+}
+
+/**
+ * Reads the index from file.
+ * @param path The path of the index file.
+ * @param input The deflated data the index should belong to.
+ * @param size The number of bytes of deflated data.
+ */
+void ZIndex::Load(const wchar_t *path, const char *input, size_t size)
+{
+    std::FILE *file;
+    int header[5], entry[4];
+    bool failed = false;
+
+    Release();
+
+    if (_wfopen_s(&file, path, L"rb"))
+    {
+        throw Exception("Could not open index at path '%ls'.", path);
+    }
+
+    failed |= (fread(header, sizeof(header), 1, file) != 1);
+    failed |= (header[0] != ZINDEX_MAGIC || header[1] != ZINDEX_VERSION);
+    failed |= (header[3] < 0 || header[4] < 0);
+
+    if (!failed && header[2] != (int)Signature(input, size))
+    {
+        fclose(file);
+        throw Exception("Index at path '%ls' is out of date.", path);
+    }
+
+    for (int i = 0; i < header[3] && !failed; i++)
+    {
+        struct ZCheckpoint *point;
+
+        failed |= (fread(entry, sizeof(entry), 1, file) != 1);
+        failed |= (entry[3] < 0 || entry[3] > ZINDEX_WINDOW || entry[2] < 0 || entry[2] > 7);
+        failed |= ((size_t)entry[1] > size);
+        failed |= (entry[2] != 0 && entry[1] == 0);     // The bits are of the byte before
+        if (failed)
+        {
+            break;
+        }
+
+        point = (struct ZCheckpoint*)malloc(sizeof(struct ZCheckpoint));
+        if (point == nullptr)
+        {
+            fclose(file);
+            throw Exception("Out of memory (checkpoint)");
+        }
+
+        point->out = (unsigned int)entry[0];
+        point->in = (unsigned int)entry[1];
+        point->bits = entry[2];
+        point->window_s = entry[3];
+        checkpoints.push_back(point);
+
+        failed |= (fread(point->window, 1, point->window_s, file) != (size_t)point->window_s);
+    }
+
+    for (int i = 0; i < header[4] && !failed; i++)
+    {
+        struct ZIndexEntry asset;
+
+        failed |= (fread(entry, sizeof(entry), 1, file) != 1);
+        failed |= (entry[3] < 0 || entry[3] > 0xFFFF);
+        if (failed)
+        {
+            break;
+        }
+
+        asset.type = entry[0];
+        asset.start = (unsigned int)entry[1];
+        asset.end = (unsigned int)entry[2];
+        asset.name = (char*)malloc(entry[3] + 1);
+        if (asset.name == nullptr)
+        {
+            fclose(file);
+            throw Exception("Out of memory (index)");
+        }
+
+        failed |= (fread(asset.name, 1, entry[3], file) != (size_t)entry[3]);
+        asset.name[entry[3]] = 0;
+        assets.push_back(asset);
+    }
+
+    fclose(file);
+
+    if (failed)
+    {
+        Release();
+        throw Exception("Corrupted index at path '%ls'.", path);
+    }
+}
+
+/**
+ * Finds an asset by name.
+ * @param name The name of the asset.
+ * @return The entry or nullptr when there is no such asset.
+ */
+const struct ZIndexEntry* ZIndex::Find(const char *name)
+{
+    for (size_t i = 0; i < assets.size(); i++)
+    {
+        if (strcmp(assets[i].name, name) == 0)
+        {
+            return &assets[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Inflates only the decompressed range of an asset, resuming at the closest
+ * checkpoint before it.
+ * @param input The deflated data, starting at the ZLib header.
+ * @param size The number of bytes of deflated data.
+ * @param entry The asset to extract.
+ * @param buffer Receives the data, which must be released using free().
+ */
+void ZIndex::Extract(const char *input, size_t size, const struct ZIndexEntry *entry, Buffer_t *buffer)
+{
+    struct ZCheckpoint *point = nullptr;
+    unsigned char discard[BUFFER_SIZE];
+    unsigned int skip, length;
+    z_stream strm;
+    int result;
+
+    ASSERT(
+        entry != nullptr && entry->end >= entry->start,
+        "Invalid index entry passed. (%p)",
+            entry
+    );
+
+    // Find the last checkpoint at or before the start of the asset.
+    for (size_t i = 0; i < checkpoints.size() && checkpoints[i]->out <= entry->start; i++)
+    {
+        point = checkpoints[i];
+    }
+
+    std::memset(&strm, 0, sizeof(z_stream));
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+
+    if (point == nullptr)
+    {
+        // Nothing to resume from; start at the ZLib header.
+        if (inflateInit(&strm) != Z_OK)
+        {
+            throw Exception("Failed to initialize ZLib.");
+        }
+
+        strm.next_in = (Bytef*)input;
+        strm.avail_in = (uInt)size;
+        skip = entry->start;
+    }
+    else
+    {
+        // Checkpoints sit in the middle of the stream, hence raw inflate.
+        if (inflateInit2(&strm, -15) != Z_OK)
+        {
+            throw Exception("Failed to initialize ZLib.");
+        }
+
+        if (point->bits != 0)
+        {
+            inflatePrime(&strm, point->bits, ((unsigned char)input[point->in - 1]) >> (8 - point->bits));
+        }
+        inflateSetDictionary(&strm, point->window, point->window_s);
+
+        strm.next_in = (Bytef*)(input + point->in);
+        strm.avail_in = (uInt)(size - point->in);
+        skip = (entry->start - point->out);
+    }
+
+    length = (entry->end - entry->start);
+    buffer->size = length;
+    buffer->data = malloc((length != 0) ? length : 1);
+    if (buffer->data == nullptr)
+    {
+        inflateEnd(&strm);
+        throw Exception("Out of memory (extract)");
+    }
+
+    // Inflate up to the asset and throw the output away.
+    result = Z_OK;
+    while (skip > 0 && result == Z_OK)
+    {
+        strm.next_out = discard;
+        strm.avail_out = (skip < BUFFER_SIZE) ? skip : BUFFER_SIZE;
+        result = inflate(&strm, Z_NO_FLUSH);
+        skip -= ((((skip < BUFFER_SIZE) ? skip : BUFFER_SIZE)) - strm.avail_out);
+    }
+
+    // Inflate the asset itself.
+    strm.next_out = (Bytef*)buffer->data;
+    strm.avail_out = length;
+    while (strm.avail_out > 0 && result == Z_OK)
+    {
+        result = inflate(&strm, Z_NO_FLUSH);
+    }
+
+    inflateEnd(&strm);
+
+    if (skip > 0 || strm.avail_out > 0)
+    {
+        free(buffer->data);
+        buffer->data = nullptr;
+        buffer->size = 0;
+        throw Exception("Could not extract asset '%s'. (%i)", entry->name, result);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef ZINDEX_HPP
+#define ZINDEX_HPP
+
+#include <vector>
+#include <zlib.h>
+#include "utility.hpp"
+#include "buffer.hpp"
+
+#define ZINDEX_MAGIC        0x58494646  /* FFIX */
+#define ZINDEX_VERSION      1
+#define ZINDEX_SPAN         0x100000    /* Decompressed bytes between checkpoints. */
+#define ZINDEX_WINDOW       32768
+
+/** Inflate state at a deflate block boundary, enough to resume from. */
+struct ZCheckpoint
+{
+    unsigned int out;                   // Decompressed offset
+    unsigned int in;                    // Compressed offset, from the ZLib header
+    int bits;                           // Bits of byte (in - 1) not yet used
+    int window_s;
+    unsigned char window[ZINDEX_WINDOW];
+};
+
+/** Decompressed range of a single asset. */
+struct ZIndexEntry
+{
+    int type;
+    unsigned int start;
+    unsigned int end;
+    char *name;
+};
+
+/**
+ * Random access index over the deflated part of a fast file, stored next to
+ * it as a .ffidx file. See zran.c in the ZLib examples for the technique.
+ */
+class ZIndex
+{
+public:
+    ZIndex(void);
+    ~ZIndex(void);
+    void Release(void) noexcept;
+
+    void AddCheckpoint(z_stream *strm);
+    void AddAsset(int type, const char *name, unsigned int start, unsigned int end);
+
+    void Save(const wchar_t *path, const char *input, size_t size);
+    void Load(const wchar_t *path, const char *input, size_t size);
+
+    const struct ZIndexEntry* Find(const char *name);
+    void Extract(const char *input, size_t size, const struct ZIndexEntry *entry, Buffer_t *buffer);
+
+private:
+    static unsigned int Signature(const char *input, size_t size);
+
+private:
+    std::vector<struct ZCheckpoint*> checkpoints;
+    std::vector<struct ZIndexEntry> assets;
+};
+
+#endif /* ZINDEX_HPP */
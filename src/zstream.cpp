@@ -1,80 +1,164 @@
 #include <cstdio>
 #include <cstring>
-#include <assert.h>
+#include <climits>
 #include <exception>
-#include <zlib.h>
 #include "stream.hpp"
 #include "zstream.hpp"
-
-#define ZSTREAM_OK      0
-#define ZSTREAM_FREAD   (-1)
-#define ZSTREAM_ZERROR  (-2)
-#define ZSTREAM_ZDATA   (-3)
+#include "decompressor.hpp"
 
 ZLibStream::ZLibStream(std::FILE *source) :
     Stream(source)
 {
-    std::memset(&zStruct, 0, sizeof(z_stream));
-    zStruct.zalloc = Z_NULL;
-    zStruct.zfree = Z_NULL;
-    zStruct.opaque = Z_NULL;
-    zStruct.avail_in = 0;
-    zStruct.next_in = Z_NULL;
-
-    if (Z_OK != inflateInit(&zStruct))
+    // Only ZLib takes its input in parts.
+    decompressor = Decompressor::Create(DECOMPRESSOR_ZLIB);
+}
+
+/**
+ * Creates a stream which inflates a block of memory in one go, e.g. a mapped
+ * file. The input is handed to the backend as is, hence it must outlive the
+ * stream.
+ * @param input The deflated data.
+ * @param size The number of bytes of deflated data.
+ * @param decompressor The DECOMPRESSOR_* backend to inflate with.
+ */
+ZLibStream::ZLibStream(const void *input, size_t size, int decompressor) :
+    Stream(nullptr)
+{
+    this->decompressor = Decompressor::Create(decompressor);
+
+    try
     {
-        throw new std::exception("Failed to initialize ZLib.\n");
+        this->decompressor->SetInput(input, size);
+    }
+    catch (...)
+    {
+        delete this->decompressor;
+        throw;
     }
 }
 
 ZLibStream::~ZLibStream(void)
 {
-    inflateEnd(&zStruct);
+    delete decompressor;
+}
+
+/**
+ * Records checkpoints into the index while inflating. Must be set before the
+ * first byte is read.
+ * @param index The index to fill, or nullptr to stop indexing.
+ */
+void ZLibStream::SetIndex(ZIndex *index)
+{
+    if (!decompressor->SetIndex(index))
+    {
+        throw std::exception("The decompressor can not build an index.\n");
+    }
+}
+
+/**
+ * Gets the name of the backend, e.g. for benchmarks.
+ */
+const char* ZLibStream::GetDecompressorName(void)
+{
+    return decompressor->GetName();
 }
 
 int ZLibStream::FillIn(void)
 {
     size_t read;
 
+    /* Memory input is handed over completely at construction. */
+    if (source == nullptr)
+    {
+        return ZSTREAM_FREAD;
+    }
+
     read = fread_s(zBuffer, BUFFER_SIZE, 1, BUFFER_SIZE, source);
     if (ferror(source) || read == 0)
     {
         return ZSTREAM_FREAD;
     }
 
-    zStruct.avail_in = (uInt)read;
-    zStruct.next_in = (Bytef*)zBuffer;
+    decompressor->SetInput(zBuffer, read);
 
     return ZSTREAM_OK;
 }
 
-int ZLibStream::FillOut(void)
+/**
+ * Decompresses at least one byte, unless the data ended or is corrupted.
+ * Reads input as the backend asks for it.
+ * @param dest The destination to decompress to.
+ * @param size The number of bytes requested.
+ * @param written Receives the number of bytes decompressed.
+ */
+int ZLibStream::Decompress(char *dest, int size, int *written)
 {
     int result;
 
-    zStruct.avail_out = BUFFER_SIZE;
-    zStruct.next_out = (Bytef*)buffer;
+    for (;;)
+    {
+        result = decompressor->Decompress(dest, size, written);
 
-    result = inflate(&zStruct, Z_NO_FLUSH);
+        /* Fatal */
+        if (result == DECOMPRESS_ERROR)
+        {
+            return ZSTREAM_ZERROR;
+        }
 
-    /* Fatal */
-    if (result == Z_STREAM_ERROR)
-    {
-        return ZSTREAM_ZERROR;
+        /* Corrupted data */
+        if (result == DECOMPRESS_DATA)
+        {
+            return ZSTREAM_ZDATA;
+        }
+
+        if (*written > 0)
+        {
+            return ZSTREAM_OK;
+        }
+
+        /* No more data */
+        if (result == DECOMPRESS_END)
+        {
+            return ZSTREAM_FREAD;
+        }
+
+        /* Refill the input stream, stop when there is nothing left. */
+        if (result == DECOMPRESS_INPUT)
+        {
+            result = FillIn();
+            if (result)
+            {
+                return result;
+            }
+        }
     }
+}
+
+/**
+ * Inflates straight into the destination instead of the stream buffer. This
+ * saves copying bulk data, like raw file bodies and shaders, a second time.
+ * @param dest The destination to inflate to.
+ * @param size The number of bytes requested.
+ * @return The number of bytes inflated, or negative on error.
+ */
+int ZLibStream::ReadDirect(char *dest, int size)
+{
+    int result, written, total;
 
-    /* Corrupted data */
-    if (result == Z_NEED_DICT ||
-        result == Z_DATA_ERROR ||
-        result == Z_MEM_ERROR)
+    for (total = 0; total < size; total += written)
     {
-        return ZSTREAM_ZDATA;
+        result = Decompress(dest + total, size - total, &written);
+        if (result == ZSTREAM_FREAD)
+        {
+            break;
+        }
+        if (result)
+        {
+            return result;
+        }
     }
 
-    available = (BUFFER_SIZE - zStruct.avail_out);
-    relPosition = 0;
-
-    return ZSTREAM_OK;
+    return total;
 }
 
 int ZLibStream::Refill(void)
@@ -84,35 +168,15 @@ int ZLibStream::Refill(void)
     /* Double check */
     if (available == 0)
     {
-        /* Refill the output stream. */
-        result = FillOut();
+        relPosition = 0;
+
+        result = Decompress(buffer, BUFFER_SIZE, &available);
         if (result)
         {
+            available = 0;
             return result;
         }
-
-        /* Output buffer may be empty, in which case we need to refill the input. */
-        if (available == 0)
-        {
-            /* Ensure we have zero input. */
-            assert(zStruct.avail_in == 0);
-
-            /* Refill the input stream. */
-            result = FillIn();
-            if (result)
-            {
-                return result;
-            }
-
-            /* Refill the output. */
-            result = FillOut();
-            if (result)
-            {
-                return result;
-            }
-        }
     }
 
-    assert(available > 0);
     return ZSTREAM_OK;
 }
@@ -2,24 +2,35 @@
 #define ZSTREAM_HPP
 
 #include <cstdio>
-#include <zlib.h>
 #include "stream.hpp"
+#include "zindex.hpp"
+#include "decompressor.hpp"
+
+#define ZSTREAM_OK      0
+#define ZSTREAM_FREAD   (-1)
+#define ZSTREAM_ZERROR  (-2)
+#define ZSTREAM_ZDATA   (-3)
 
 class ZLibStream : public Stream
 {
 public:
     ZLibStream(std::FILE *source);
+    ZLibStream(const void *input, size_t size, int decompressor = DECOMPRESSOR_ZLIB);
     ~ZLibStream(void);
 
+    void SetIndex(ZIndex *index);
+    const char* GetDecompressorName(void);
+
 protected:
     int Refill(void);
+    int ReadDirect(char *dest, int size);
 
 private:
     int FillIn(void);
-    int FillOut(void);
+    int Decompress(char *dest, int size, int *written);
 
 private:
-    z_stream zStruct;
+    Decompressor *decompressor;
     char zBuffer[BUFFER_SIZE];
 };
 